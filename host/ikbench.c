@@ -0,0 +1,509 @@
+//*****************************************************************************
+//
+// ikbench.c - Throughput benchmark for the ikdecode host decoders
+//
+//   ikbench <uart|usb|can|log> <capture|->   Decode a capture file (or a live
+//                                            device read from stdin)
+//   ikbench synth [MB]                       Decode generated traffic of each
+//                                            transport, raw and delta
+//                                            compressed, and check it round-trips
+//   ikbench suite-diff <old> <new> [%]       Compare the benchmark suite records
+//                                            of two builds; fails on a field
+//                                            worse by more than % (default 5)
+//
+// Captures: uart - the raw byte stream of UART0 or the virtual COM port;
+// usb - each IN packet as a 2-byte little-endian length and the packet;
+// can - 13-byte records, the 32-bit big-endian ID (bit 31 set for a 29-bit
+// ID), the DLC and 8 data bytes; log - raw log pages (icmdFlashGetData output
+// or a BIN file of the mass-storage volume), IKBENCH_PAGE bytes each.
+// Suite records: the icmdBenchSuite reply words in hex (0x optional),
+// separated by white space
+//
+//*****************************************************************************
+
+#if !defined(__TI_ARM__)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ikdecode.h"
+
+#ifndef IKBENCH_PAGE
+#define IKBENCH_PAGE 1024          // Log page size of the capture (4096 for SPI NOR)
+#endif
+
+#define SYNTH_UART_HALVES  32      // Halfwords of a generated UART frame
+#define SYNTH_USB_HALVES   30      // Halfwords of a generated USB STREAM packet
+
+typedef struct {
+    uint64_t Samples;              // Samples reported
+    uint64_t LostSamples;          // Of them, in frames marked lost
+    uint32_t Check;                // Running check of the values (synth round-trip)
+} bench_t;
+
+static void Bench_Samples(void *Ctx, const uint16_t *Samples, size_t Count, bool Lost)
+{
+    bench_t *Bench = (bench_t *)Ctx;
+    size_t i;
+
+    Bench->Samples += Count;
+    if (Lost)
+        Bench->LostSamples += Count;
+    for (i = 0; i < Count; i++)
+        Bench->Check = Bench->Check * 31 + Samples[i];
+}
+
+static double Bench_Now(void)
+{
+    struct timespec Ts;
+
+    timespec_get(&Ts, TIME_UTC);
+    return Ts.tv_sec + Ts.tv_nsec * 1e-9;
+}
+
+static void Bench_Report(const char *Name, uint64_t Bytes, double Secs, const bench_t *Bench,
+                         uint64_t Errors)
+{
+    if (Secs <= 0)
+        Secs = 1e-9;
+    printf("%-12s %10.1f MB  %8.1f MB/s  %12llu samples  %8.2f Msamples/s  %llu errors\n",
+           Name, Bytes / 1e6, Bytes / 1e6 / Secs, (unsigned long long)Bench->Samples,
+           Bench->Samples / 1e6 / Secs, (unsigned long long)Errors);
+}
+
+//*****************************************************************************
+//
+// Capture Decoding
+//
+//*****************************************************************************
+
+static int Bench_File(const char *Kind, const char *Path)
+{
+    static uint8_t Buf[1 << 16];
+    static uint8_t Page[4096], Xfer[1 << 16];
+    bench_t Bench;
+    ik_events_t Ev;
+    ik_uart_t Uart;
+    ik_usb_t Usb;
+    ik_can_t Can;
+    ik_log_t Log;
+    FILE *In = strcmp(Path, "-") ? fopen(Path, "rb") : stdin;
+    uint64_t Bytes = 0, Errors = 0;
+    size_t Len, Want;
+    uint32_t Id;
+    double Start;
+    int Result;
+
+    if (!In)
+    {
+        perror(Path);
+        return 1;
+    }
+    memset(&Bench, 0, sizeof(Bench));
+    memset(&Ev, 0, sizeof(Ev));
+    Ev.Samples = Bench_Samples;
+    Ev.Ctx = &Bench;
+    Ik_UartInit(&Uart);
+    Ik_UsbInit(&Usb);
+    memset(&Can, 0, sizeof(Can));
+    Ik_CanInit(&Can, Page, IKBENCH_PAGE, Xfer, sizeof(Xfer));
+    Ik_LogInit(&Log);
+
+    Start = Bench_Now();
+    if (!strcmp(Kind, "uart"))
+    {
+        while ((Len = fread(Buf, 1, sizeof(Buf), In)) > 0)
+        {
+            Ik_UartFeed(&Uart, Buf, Len, &Ev);
+            Bytes += Len;
+        }
+        Errors = Uart.CrcErrors + Uart.SeqGaps;
+    }
+    else if (!strcmp(Kind, "usb"))
+    {
+        while (fread(Buf, 1, 2, In) == 2)
+        {
+            Want = Buf[0] | (Buf[1] << 8);
+            if (Want > IK_USB_PKT_SIZE || fread(Buf, 1, Want, In) != Want)
+                break;
+            if (Ik_UsbPacket(&Usb, Buf, Want, &Ev) < 0)
+                Errors++;
+            Bytes += Want;
+        }
+        Errors += Usb.SeqGaps;
+    }
+    else if (!strcmp(Kind, "can"))
+    {
+        while (fread(Buf, 1, 13, In) == 13)
+        {
+            Id = ((uint32_t)Buf[0] << 24) | ((uint32_t)Buf[1] << 16) | (Buf[2] << 8) | Buf[3];
+            Ik_CanFrame(&Can, Id & 0x1FFFFFFF, (Id & 0x80000000) != 0, Buf + 5,
+                        Buf[4] > 8 ? 8 : Buf[4], &Ev);
+            Bytes += Buf[4];
+        }
+        Errors = Can.SeqGaps + Can.BadWindows + Can.BadPages + Can.XferErrors;
+    }
+    else if (!strcmp(Kind, "log"))
+    {
+        while (fread(Page, 1, IKBENCH_PAGE, In) == IKBENCH_PAGE)
+        {
+            Result = Ik_LogPage(&Log, Page, IKBENCH_PAGE, &Ev);
+            if (Result < 0)
+                Errors++;
+            Bytes += IKBENCH_PAGE;
+        }
+        Errors += Log.SeqGaps;
+    }
+    else
+    {
+        fprintf(stderr, "unknown transport '%s'\n", Kind);
+        return 1;
+    }
+
+    Bench_Report(Kind, Bytes, Bench_Now() - Start, &Bench, Errors);
+    if (In != stdin)
+        fclose(In);
+    return 0;
+}
+
+//*****************************************************************************
+//
+// Synthetic Traffic: a slowly wandering 12-bit signal with an occasional
+// step, encoded the way the firmware encodes it (Delta_Encode / Delta_Drain
+// and StreamPack_* in main.c)
+//
+//*****************************************************************************
+
+typedef struct {
+    uint16_t Prev;
+    uint8_t Pend[4];
+    int Count;
+    bool Keyed;
+} synth_enc_t;
+
+static uint32_t SynthSeed = 12345;
+static uint16_t SynthLevel = 2048;
+
+static uint16_t Synth_Next(void)
+{
+    int32_t Step;
+
+    SynthSeed = SynthSeed * 1103515245 + 12345;
+    Step = (int32_t)((SynthSeed >> 16) % 7) - 3;
+    if (((SynthSeed >> 8) & 0xFF) == 0)
+        Step = (int32_t)((SynthSeed >> 12) & 0x3FF) - 512;
+    SynthLevel = (uint16_t)((SynthLevel + Step) & 0x0FFF);
+    return SynthLevel;
+}
+
+static int Synth_Drain(synth_enc_t *Enc, uint16_t *Out, bool All)
+{
+    int Emitted = 0, i, Take, Max;
+
+    while (Enc->Count > 0)
+    {
+        Max = 0;
+        for (i = 0; i < Enc->Count; i++)
+            if (Enc->Pend[i] > Max) Max = Enc->Pend[i];
+        if (Max <= 0x07)
+        {
+            if (Enc->Count < 4 && !All)
+                break;
+            Out[Emitted] = (uint16_t)(IK_DELTA_TAG_QUAD | ((Enc->Count - 1) << 12));
+            for (i = 0; i < Enc->Count; i++)
+                Out[Emitted] |= (uint16_t)(Enc->Pend[i] << (i * 3));
+            Take = Enc->Count;
+        }
+        else
+        {
+            if (Enc->Count < 2 && !All)
+                break;
+            Take = (Enc->Count < 2) ? 1 : 2;
+            Out[Emitted] = (uint16_t)(IK_DELTA_TAG_PAIR | ((Take - 1) << 12) | Enc->Pend[0]);
+            if (Take > 1)
+                Out[Emitted] |= (uint16_t)(Enc->Pend[1] << 6);
+        }
+        Emitted++;
+        Enc->Count -= Take;
+        for (i = 0; i < Enc->Count; i++)
+            Enc->Pend[i] = Enc->Pend[i + Take];
+    }
+    return Emitted;
+}
+
+static int Synth_Encode(synth_enc_t *Enc, uint16_t Sample, uint16_t *Out)
+{
+    int32_t Delta = (int32_t)Sample - (int32_t)Enc->Prev;
+    uint32_t Zig = ((uint32_t)Delta << 1) ^ (uint32_t)(Delta >> 31);
+    int Emitted;
+
+    Enc->Prev = Sample;
+    if (!Enc->Keyed || Zig > 0x3F)
+    {
+        Emitted = Synth_Drain(Enc, Out, true);
+        Out[Emitted++] = Sample;
+        Enc->Keyed = true;
+        return Emitted;
+    }
+    Enc->Pend[Enc->Count++] = (uint8_t)Zig;
+    return Synth_Drain(Enc, Out, false);
+}
+
+// Fills a frame payload (BE halfwords) of at most Cap halfwords; returns the
+// halfword count, the samples taken in *Samples
+static size_t Synth_Payload(uint8_t *Out, size_t Cap, bool Delta, uint32_t *Samples, uint32_t *Check)
+{
+    synth_enc_t Enc;
+    uint16_t Half[8];
+    size_t Count = 0;
+    int n, i;
+
+    memset(&Enc, 0, sizeof(Enc));
+    *Samples = 0;
+    while (Count + (Delta ? 3 : 1) <= Cap)
+    {
+        Half[0] = Synth_Next();
+        *Check = *Check * 31 + Half[0];
+        (*Samples)++;
+        n = Delta ? Synth_Encode(&Enc, Half[0], Half) : 1;
+        for (i = 0; i < n; i++, Count++)
+        {
+            Out[Count * 2] = (uint8_t)(Half[i] >> 8);
+            Out[Count * 2 + 1] = (uint8_t)Half[i];
+        }
+    }
+    if (Delta)
+    {
+        n = Synth_Drain(&Enc, Half, true);
+        for (i = 0; i < n; i++, Count++)
+        {
+            Out[Count * 2] = (uint8_t)(Half[i] >> 8);
+            Out[Count * 2 + 1] = (uint8_t)Half[i];
+        }
+    }
+    return Count;
+}
+
+static int Synth_Run(const char *Name, int Kind, bool Delta, size_t Target)
+{
+    uint8_t *Buf = (uint8_t *)malloc(Target + 4096);
+    size_t Len = 0, Frame, Count, Off;
+    uint32_t Seq = 0, Samples, Check = 0, Id;
+    uint64_t Total = 0, Errors = 0;
+    bench_t Bench;
+    ik_events_t Ev;
+    ik_uart_t Uart;
+    ik_usb_t Usb;
+    ik_can_t Can;
+    uint16_t Crc;
+    double Start;
+    int i;
+
+    if (!Buf)
+        return 1;
+
+    // Generate the traffic: frames back to back (UART), 64-byte slots of one
+    // packet each (USB), or 13-byte CAN records as the capture format
+    while (Len + 600 < Target)
+    {
+        if (Kind == 0)
+        {
+            Count = Synth_Payload(Buf + Len + IK_UART_HEADER, SYNTH_UART_HALVES, Delta, &Samples, &Check);
+            Buf[Len] = IK_UART_SYNC0;
+            Buf[Len + 1] = IK_UART_SYNC1;
+            Buf[Len + 2] = (uint8_t)(Seq >> 8);
+            Buf[Len + 3] = (uint8_t)Seq;
+            Buf[Len + 4] = (uint8_t)Count;
+            Buf[Len + 5] = Delta ? IK_UART_DELTA : 0;
+            Frame = IK_UART_HEADER + Count * 2;
+            Crc = Ik_Crc16(0, Buf + Len + 2, Frame - 2);
+            Buf[Len + Frame] = (uint8_t)(Crc >> 8);
+            Buf[Len + Frame + 1] = (uint8_t)Crc;
+            Len += Frame + 2;
+        }
+        else if (Kind == 1)
+        {
+            Count = Synth_Payload(Buf + Len + IK_USB_PKT_HEADER, SYNTH_USB_HALVES, Delta, &Samples, &Check);
+            Buf[Len] = IK_USB_PKT_STREAM;
+            Buf[Len + 1] = (uint8_t)Seq;
+            Buf[Len + 2] = (uint8_t)Count;
+            Buf[Len + 3] = Delta ? IK_USB_STREAM_DELTA : 0;
+            Len += IK_USB_PKT_SIZE;
+        }
+        else
+        {
+            Buf[Len] = 0;
+            Buf[Len + 1] = 0;
+            Buf[Len + 2] = (uint8_t)(IK_CAN_STREAM_ID >> 8);
+            Buf[Len + 3] = (uint8_t)IK_CAN_STREAM_ID;
+            Buf[Len + 4] = 8;
+            Buf[Len + 5] = (uint8_t)Seq;
+            Buf[Len + 6] = 3;
+            for (i = 0; i < 3; i++)
+            {
+                Samples = Synth_Next();
+                Check = Check * 31 + Samples;
+                Buf[Len + 7 + i * 2] = (uint8_t)(Samples >> 8);
+                Buf[Len + 8 + i * 2] = (uint8_t)Samples;
+            }
+            Len += 13;
+        }
+        Seq++;
+    }
+
+    memset(&Bench, 0, sizeof(Bench));
+    memset(&Ev, 0, sizeof(Ev));
+    Ev.Samples = Bench_Samples;
+    Ev.Ctx = &Bench;
+    Ik_UartInit(&Uart);
+    Ik_UsbInit(&Usb);
+    memset(&Can, 0, sizeof(Can));
+    Ik_CanInit(&Can, 0, 0, 0, 0);
+
+    Start = Bench_Now();
+    if (Kind == 0)
+    {
+        // Fed in USB-sized reads, as a host serial driver returns them
+        for (Off = 0; Off < Len; Off += 64)
+            Ik_UartFeed(&Uart, Buf + Off, (Len - Off < 64) ? Len - Off : 64, &Ev);
+        Errors = Uart.CrcErrors + Uart.SeqGaps + Uart.SkippedBytes;
+        Total = Len;
+    }
+    else if (Kind == 1)
+    {
+        for (Off = 0; Off < Len; Off += IK_USB_PKT_SIZE)
+        {
+            Frame = IK_USB_PKT_HEADER + Buf[Off + 2] * 2;
+            if (Ik_UsbPacket(&Usb, Buf + Off, Frame, &Ev) < 0)
+                Errors++;
+            Total += Frame;
+        }
+        Errors += Usb.SeqGaps;
+    }
+    else
+    {
+        for (Off = 0; Off < Len; Off += 13)
+        {
+            Id = ((uint32_t)Buf[Off + 2] << 8) | Buf[Off + 3];
+            Ik_CanFrame(&Can, Id, false, Buf + Off + 5, Buf[Off + 4], &Ev);
+            Total += Buf[Off + 4];
+        }
+        Errors = Can.SeqGaps;
+    }
+
+    Bench_Report(Name, Total, Bench_Now() - Start, &Bench, Errors);
+    if (Bench.Check != Check)
+    {
+        printf("%-12s round-trip FAILED\n", Name);
+        Errors++;
+    }
+    free(Buf);
+    return Errors ? 1 : 0;
+}
+
+//*****************************************************************************
+//
+// Suite Records
+//
+//*****************************************************************************
+
+static int Suite_Load(const char *Path, ik_suite_t *Rec)
+{
+    uint32_t Words[IK_SUITE_WORDS + 16];
+    unsigned long Word;
+    size_t Count = 0;
+    FILE *F = fopen(Path, "r");
+
+    if (!F)
+    {
+        perror(Path);
+        return -1;
+    }
+    while (Count < sizeof(Words) / sizeof(Words[0]) && fscanf(F, "%lx", &Word) == 1)
+        Words[Count++] = (uint32_t)Word;
+    fclose(F);
+    if (Ik_SuiteParse(Rec, Words, Count) != IK_OK)
+    {
+        fprintf(stderr, "%s: not a benchmark suite record\n", Path);
+        return -1;
+    }
+    if (Rec->State != IK_SUITE_STATE_DONE)
+        fprintf(stderr, "%s: the run did not finish (state %u)\n", Path, Rec->State);
+    return 0;
+}
+
+static int Suite_Diff(const char *OldPath, const char *NewPath, double Percent)
+{
+    ik_suite_t Old, New;
+    int32_t PerMille;
+    uint32_t i;
+    int Worse = 0;
+
+    if (Suite_Load(OldPath, &Old) || Suite_Load(NewPath, &New))
+        return 2;
+
+    printf("%-12s %12u %12u  (build)\n", "", Old.Build, New.Build);
+    for (i = 0; i < IK_SUITE_FIELDS; i++)
+    {
+        printf("%-12s ", Ik_SuiteName(i));
+        if (Old.Value[i] == IK_SUITE_NONE)
+            printf("%12s ", "-");
+        else
+            printf("%12u ", Old.Value[i]);
+        if (New.Value[i] == IK_SUITE_NONE)
+            printf("%12s ", "-");
+        else
+            printf("%12u ", New.Value[i]);
+        printf(" %-10s", Ik_SuiteUnit(i));
+        if (Ik_SuiteDiff(&Old, &New, i, &PerMille) == IK_OK)
+        {
+            printf(" %+7.1f%%", PerMille / 10.0);
+            if (PerMille < -Percent * 10)
+            {
+                printf("  worse");
+                Worse++;
+            }
+            else if (PerMille > Percent * 10)
+            {
+                printf("  better");
+            }
+        }
+        printf("\n");
+    }
+    return Worse ? 1 : 0;
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+
+int main(int argc, char **argv)
+{
+    size_t Target;
+    int Failed = 0;
+
+    if (argc >= 2 && !strcmp(argv[1], "synth"))
+    {
+        Target = (size_t)((argc >= 3) ? atof(argv[2]) * 1e6 : 64e6);
+        Failed |= Synth_Run("uart", 0, false, Target);
+        Failed |= Synth_Run("uart-delta", 0, true, Target);
+        Failed |= Synth_Run("usb", 1, false, Target);
+        Failed |= Synth_Run("usb-delta", 1, true, Target);
+        Failed |= Synth_Run("can", 2, false, Target);
+        return Failed;
+    }
+    if ((argc == 4 || argc == 5) && !strcmp(argv[1], "suite-diff"))
+        return Suite_Diff(argv[2], argv[3], (argc == 5) ? atof(argv[4]) : 5.0);
+    if (argc == 3)
+        return Bench_File(argv[1], argv[2]);
+
+    fprintf(stderr, "usage: %s <uart|usb|can|log> <capture|->\n"
+                    "       %s synth [MB]\n"
+                    "       %s suite-diff <old> <new> [%%]\n", argv[0], argv[0], argv[0]);
+    return 2;
+}
+
+#endif
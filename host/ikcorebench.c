@@ -0,0 +1,442 @@
+//*****************************************************************************
+//
+// ikcorebench.c - Throughput benchmark of the firmware core (../ikcore.c) on
+// the host
+//
+//   ikcorebench [Msamples]      Run each kernel and the acquisition and command
+//                               paths over that many samples (default 16) and
+//                               report the rate and time per operation
+//
+// The kernels are the firmware's own code: the circular buffer and its read
+// cursors, the delta and Rice encoders (checked against the ikdecode decoder), the
+// biquad cascade, the median window, the driverlib software CRC32 and the
+// command table lookup. The acquisition path runs frames from a mocked
+// ADCSequenceDataGet through the median and filter stages into the ring and
+// drains it through the delta encoder; the command path dispatches requests
+// whose replies go out through a mocked CANMessageSet (see ikmock.h). The
+// numbers compare builds of the core on one machine; they are not the
+// target's cycle counts
+//
+//*****************************************************************************
+
+#if !defined(__TI_ARM__)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../ikcore.h"
+#include "driverlib/sw_crc.h"
+#include "ikmock.h"
+#include "ikdecode.h"
+
+#define BENCH_RING      4096       // Ring elements (the firmware sizes SensorBuf from SRAM)
+#define BENCH_READERS   3          // Read cursors of the shared-ring run
+#define BENCH_CHANNELS  4          // Channels of the acquisition path's frames
+#define BENCH_SECTIONS  2          // Biquads of the filter runs
+#define BENCH_MEDIAN    5          // Median window of the median runs
+#define BENCH_PAGE      512        // Halfwords per CRC32 block (a 1KB log page)
+
+static sample_t RingData[BENCH_RING];
+static circ_bbuf_t Ring;
+static circ_bbuf_reader_t Readers[BENCH_READERS];
+static sample_t Signal[BENCH_RING];    // One ring's worth of generated samples
+static uint32_t Check;                 // Results are folded in here so no run is optimised away
+
+static double Bench_Now(void)
+{
+    struct timespec Ts;
+
+    timespec_get(&Ts, TIME_UTC);
+    return Ts.tv_sec + Ts.tv_nsec * 1e-9;
+}
+
+static void Bench_Report(const char *Name, uint64_t Ops, double Secs)
+{
+    if (Secs <= 0)
+        Secs = 1e-9;
+    printf("%-14s %12llu ops  %9.2f Mops/s  %8.2f ns/op\n", Name, (unsigned long long)Ops,
+           Ops / 1e6 / Secs, Secs * 1e9 / Ops);
+}
+
+//*****************************************************************************
+//
+// Kernels
+//
+//*****************************************************************************
+
+static void Bench_Ring(uint64_t Count)
+{
+    uint64_t n;
+    sample_t Sample;
+    double Start = Bench_Now();
+
+    Init_circ_bbuf(&Ring, RingData, BENCH_RING);
+    for (n = 0; n < Count; n++)
+    {
+        circ_bbuf_push(&Ring, Signal[n & (BENCH_RING - 1)]);
+        if ((n & 63) == 63)
+            while (circ_bbuf_pop(&Ring, &Sample) == 0)
+                Check += Sample;
+    }
+    Bench_Report("ring push/pop", Count, Bench_Now() - Start);
+}
+
+static void Bench_Readers(uint64_t Count)
+{
+    uint64_t n;
+    int r;
+    sample_t Sample;
+    double Start = Bench_Now();
+
+    Init_circ_bbuf(&Ring, RingData, BENCH_RING);
+    circ_bbuf_readers_reset(Readers, BENCH_READERS);
+    for (n = 0; n < Count; n++)
+    {
+        circ_bbuf_push(&Ring, Signal[n & (BENCH_RING - 1)]);
+        if ((n & 63) == 63)
+            for (r = 0; r < BENCH_READERS; r++)
+                while (circ_bbuf_reader_pop(&Ring, Readers, BENCH_READERS, r, &Sample) == 0)
+                    Check += Sample;
+    }
+    Bench_Report("ring 3 readers", Count, Bench_Now() - Start);
+}
+
+static void Bench_DeltaCheck(void *Ctx, const uint16_t *Samples, size_t Count, bool Lost)
+{
+    uint64_t *Pos = (uint64_t *)Ctx;
+    size_t i;
+
+    (void)Lost;
+    for (i = 0; i < Count; i++, (*Pos)++)
+        if (Samples[i] != Signal[*Pos & (BENCH_RING - 1)])
+            *Pos |= 1ull << 63;
+}
+
+static int Bench_Delta(uint64_t Count)
+{
+    static sample_t Out[BENCH_PAGE + DELTA_MAX_OUT];
+    delta_enc_t Enc;
+    ik_half_t Dec;
+    ik_events_t Ev;
+    uint64_t n, Halves = 0, Pos = 0;
+    int Len = 0;
+    double Start;
+
+    memset(&Ev, 0, sizeof(Ev));
+    Ev.Samples = Bench_DeltaCheck;
+    Ev.Ctx = &Pos;
+    Ik_HalfInit(&Dec, true, false);
+    Delta_Reset(&Enc);
+
+    Start = Bench_Now();
+    for (n = 0; n < Count; n++)
+    {
+        Len += Delta_Encode(&Enc, Signal[n & (BENCH_RING - 1)], &Out[Len]);
+        if (Len >= BENCH_PAGE)
+        {
+            Ik_HalfFeed(&Dec, Out, Len, &Ev);
+            Halves += Len;
+            Len = 0;
+        }
+    }
+    Len += Delta_Drain(&Enc, &Out[Len], true);
+    Ik_HalfFeed(&Dec, Out, Len, &Ev);
+    Halves += Len;
+    Bench_Report("delta+decode", Count, Bench_Now() - Start);
+
+    if (Pos != Count)
+    {
+        printf("delta: round trip FAILED (%llu of %llu samples)\n",
+               (unsigned long long)(Pos & ~(1ull << 63)), (unsigned long long)Count);
+        return 1;
+    }
+    printf("delta: %.2f bits/sample, round trip ok\n", Halves * 16.0 / Count);
+    return 0;
+}
+
+static int Bench_Rice(uint64_t Count)
+{
+    static sample_t Out[BENCH_PAGE + RICE_MAX_OUT + 1];
+    rice_t Enc;
+    ik_half_t Dec;
+    ik_events_t Ev;
+    uint64_t n, Halves = 0, Pos = 0;
+    int Len = 0;
+    double Start;
+
+    memset(&Ev, 0, sizeof(Ev));
+    Ev.Samples = Bench_DeltaCheck;
+    Ev.Ctx = &Pos;
+    Ik_HalfInit(&Dec, true, false);
+    Dec.Rice = true;
+    Rice_Reset(&Enc);
+
+    Start = Bench_Now();
+    for (n = 0; n < Count; n++)
+    {
+        Len += Rice_Encode(&Enc, Signal[n & (BENCH_RING - 1)], &Out[Len]);
+        if (Len >= BENCH_PAGE)
+        {
+            Ik_HalfFeed(&Dec, Out, Len, &Ev);
+            Halves += Len;
+            Len = 0;
+        }
+    }
+    Len += Rice_Drain(&Enc, &Out[Len]);
+    Ik_HalfFeed(&Dec, Out, Len, &Ev);
+    Halves += Len;
+    Bench_Report("rice+decode", Count, Bench_Now() - Start);
+
+    if (Pos != Count)
+    {
+        printf("rice: round trip FAILED (%llu of %llu samples)\n",
+               (unsigned long long)(Pos & ~(1ull << 63)), (unsigned long long)Count);
+        return 1;
+    }
+    printf("rice: %.2f bits/sample, round trip ok\n", Halves * 16.0 / Count);
+    return 0;
+}
+
+// A low-pass pair near 0.05 of the rate (Q14), the shape icmdSetFilterCoef sets up
+static const int16_t BenchCoef[BENCH_SECTIONS][5] = {
+    {346, 692, 346, -25243, 10243},
+    {346, 692, 346, -25243, 10243}
+};
+
+static void Bench_Biquad(uint64_t Count)
+{
+    biquad_t Bq[BENCH_SECTIONS];
+    biquad_state_t St[BENCH_SECTIONS];
+    uint64_t n;
+    int32_t X;
+    double Start;
+    int i;
+
+    for (i = 0; i < BENCH_SECTIONS; i++)
+    {
+        memcpy(Bq[i].Coef, BenchCoef[i], sizeof(Bq[i].Coef));
+        Biquad_Pack(&Bq[i]);
+    }
+
+    Start = Bench_Now();
+    for (n = 0; n < Count; n++)
+    {
+        X = Biquad_Cascade(Bq, St, BENCH_SECTIONS, (int32_t)Signal[n & (BENCH_RING - 1)] << 2, n == 0);
+        Check += (uint32_t)X;
+    }
+    Bench_Report("biquad x2", Count, Bench_Now() - Start);
+}
+
+static void Bench_Median(uint64_t Count)
+{
+    median_t Med;
+    uint64_t n;
+    double Start;
+
+    memset(&Med, 0, sizeof(Med));
+    Med.Width = BENCH_MEDIAN;
+
+    Start = Bench_Now();
+    for (n = 0; n < Count; n++)
+        Check += Median_Step(&Med, Signal[n & (BENCH_RING - 1)]);
+    Bench_Report("median 5", Count, Bench_Now() - Start);
+}
+
+static void Bench_Crc(uint64_t Count)
+{
+    uint64_t n;
+    uint32_t Crc = 0xFFFFFFFF;
+    double Start = Bench_Now();
+
+    for (n = 0; n < Count; n += BENCH_PAGE)
+        Crc = Crc32(Crc, (const uint8_t *)&Signal[n & (BENCH_RING - BENCH_PAGE)], BENCH_PAGE * 2);
+    Check += Crc;
+    Bench_Report("crc32 (bytes)", (Count / BENCH_PAGE) * BENCH_PAGE * 2, Bench_Now() - Start);
+}
+
+//*****************************************************************************
+//
+// Acquisition Path: a frame per ADCSequenceDataGet, each sample through its
+// channel's median window and the biquads, into the ring; every 64 frames
+// the main loop side drains the ring through the delta encoder
+//
+//*****************************************************************************
+
+static void Bench_Acquire(uint64_t Count)
+{
+    static sample_t Out[BENCH_PAGE + DELTA_MAX_OUT];
+    uint32_t Frame[IKMOCK_ADC_MAX_STEPS];
+    biquad_t Bq[BENCH_SECTIONS];
+    biquad_state_t St[BENCH_CHANNELS][BENCH_SECTIONS];
+    median_t Med[BENCH_CHANNELS];
+    delta_enc_t Enc;
+    uint64_t Frames = Count / BENCH_CHANNELS, n;
+    sample_t *Span;
+    int32_t X;
+    int Len = 0, Got, k;
+    uint32_t i;
+    double Start;
+
+    IkMock_Init(BENCH_CHANNELS, 4096, 1000);
+    memset(Med, 0, sizeof(Med));
+    for (i = 0; i < BENCH_CHANNELS; i++)
+        Med[i].Width = 3;
+    for (i = 0; i < BENCH_SECTIONS; i++)
+    {
+        memcpy(Bq[i].Coef, BenchCoef[i], sizeof(Bq[i].Coef));
+        Biquad_Pack(&Bq[i]);
+    }
+    Init_circ_bbuf(&Ring, RingData, BENCH_RING);
+    Delta_Reset(&Enc);
+
+    Start = Bench_Now();
+    for (n = 0; n < Frames; n++)
+    {
+        ADCSequenceDataGet(0, 0, Frame);
+        for (i = 0; i < BENCH_CHANNELS; i++)
+        {
+            X = (int32_t)Median_Step(&Med[i], (sample_t)(Frame[i] & SAMPLE_MASK)) << 2;
+            X = Biquad_Cascade(Bq, St[i], BENCH_SECTIONS, X, n == 0) >> 2;
+            circ_bbuf_push(&Ring, (sample_t)((X < 0) ? 0 : (X > SAMPLE_MASK) ? SAMPLE_MASK : X));
+        }
+        if ((n & 63) != 63)
+            continue;
+        while ((Got = circ_bbuf_read_span(&Ring, &Span)) > 0)
+        {
+            for (k = 0; k < Got; k++)
+            {
+                Len += Delta_Encode(&Enc, Span[k], &Out[Len]);
+                if (Len >= BENCH_PAGE)
+                {
+                    Check += Out[0];
+                    Len = 0;
+                }
+            }
+            circ_bbuf_advance_tail(&Ring, Got);
+        }
+    }
+    Bench_Report("acquire path", Frames * BENCH_CHANNELS, Bench_Now() - Start);
+    printf("acquire: %llu ADC reads, %u ring drops\n", (unsigned long long)IkMock.AdcReads,
+           (unsigned)Ring.drops);
+}
+
+//*****************************************************************************
+//
+// Command Path: requests dispatched through a handler table, the replies
+// packed into a CAN response frame and loaded by CANMessageSet
+//
+//*****************************************************************************
+
+#define BENCH_CMD_FIRST 0x01       // icmdReadVersion
+
+static tCANMsgObject BenchMsg;
+static uint8_t BenchResp[8];
+
+static void Bench_CmdReply(cmd_ctx_t *Ctx, uint32_t Value)
+{
+    Cmd_PutWord(&Ctx->Resp[4], Value);
+    BenchMsg.ui32MsgID = Ctx->ReplyID;
+    BenchMsg.ui32MsgLen = 8;
+    BenchMsg.pui8MsgData = Ctx->Resp;
+    CANMessageSet(0, 1, &BenchMsg, MSG_OBJ_TYPE_TX);
+    Ctx->Replies++;
+}
+
+static void Bench_CmdVersion(cmd_ctx_t *Ctx)
+{
+    Bench_CmdReply(Ctx, 1002);
+}
+
+static void Bench_CmdReadData(cmd_ctx_t *Ctx)
+{
+    sample_t Sample = 0;
+
+    circ_bbuf_push(&Ring, (sample_t)Ctx->Value);
+    circ_bbuf_pop(&Ring, &Sample);
+    Bench_CmdReply(Ctx, Sample);
+}
+
+static void Bench_CmdStats(cmd_ctx_t *Ctx)
+{
+    Bench_CmdReply(Ctx, Ring.pushes);
+    Bench_CmdReply(Ctx, Ring.drops);
+}
+
+static const cmd_entry_t BenchTable[] = {
+    {0x01, 0,         Bench_CmdVersion},
+    {0x02, 0,         Bench_CmdReadData},
+    {0x03, CMD_F_CAN, Bench_CmdStats},
+    {0x04, 0,         0},
+    {0x05, CMD_F_BULK, Bench_CmdStats}
+};
+
+#define BENCH_TABLE_LEN (sizeof(BenchTable) / sizeof(BenchTable[0]))
+
+static void Bench_Commands(uint64_t Count)
+{
+    cmd_ctx_t Ctx;
+    const cmd_entry_t *Entry;
+    uint64_t n, Unknown = 0;
+    double Start;
+
+    IkMock_Init(1, 0, 0);
+    Init_circ_bbuf(&Ring, RingData, BENCH_RING);
+    memset(&Ctx, 0, sizeof(Ctx));
+    Ctx.ReplyID = 0x107;
+    Ctx.Resp = BenchResp;
+
+    Start = Bench_Now();
+    for (n = 0; n < Count; n++)
+    {
+        Ctx.Source = (n % 3 == 2) ? CMD_SRC_I2C : CMD_SRC_CAN;
+        Ctx.Value = (uint32_t)n;
+        Ctx.Replies = 0;
+        BenchResp[0] = (uint8_t)(BENCH_CMD_FIRST + n % 6);
+        Entry = Cmd_Find(BenchTable, BENCH_TABLE_LEN, BenchResp[0]);
+        if (Entry == 0)
+            Unknown++;
+        else if (!Cmd_Allowed(Entry, Ctx.Source))
+            Bench_CmdReply(&Ctx, 0xFFFFFFFF);
+        else
+            Entry->Handler(&Ctx);
+    }
+    Bench_Report("commands", Count, Bench_Now() - Start);
+    printf("commands: %llu CAN frames, %llu unknown\n", (unsigned long long)IkMock.CanFrames,
+           (unsigned long long)Unknown);
+    Check += IkMock.CanCheck;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t Count = (uint64_t)(((argc >= 2) ? atof(argv[1]) : 16) * 1e6);
+    uint32_t i;
+    int Failed = 0;
+
+    if (Count < BENCH_PAGE)
+        Count = BENCH_PAGE;
+
+    // One ring of the mocked signal, single channel, with spikes
+    IkMock_Init(1, 1024, 997);
+    for (i = 0; i < BENCH_RING; i++)
+    {
+        uint32_t Frame[IKMOCK_ADC_MAX_STEPS];
+
+        ADCSequenceDataGet(0, 3, Frame);
+        Signal[i] = (sample_t)Frame[0];
+    }
+
+    Bench_Ring(Count);
+    Bench_Readers(Count);
+    Failed |= Bench_Delta(Count);
+    Failed |= Bench_Rice(Count);
+    Bench_Biquad(Count);
+    Bench_Median(Count);
+    Bench_Crc(Count);
+    Bench_Acquire(Count);
+    Bench_Commands(Count);
+    printf("check %08x\n", (unsigned)Check);
+    return Failed;
+}
+
+#endif
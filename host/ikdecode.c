@@ -0,0 +1,890 @@
+//*****************************************************************************
+//
+// ikdecode.c - Host-side decoders for the Inkley_PressureSensor wire and log
+// formats (see ikdecode.h)
+//
+//*****************************************************************************
+
+// The CCS project builds every source under the project folder; the host
+// tools stay out of the firmware image
+#if !defined(__TI_ARM__)
+
+#include <string.h>
+#include "ikdecode.h"
+
+#define IK_BATCH 1024              // Samples reported per Samples callback at most
+
+//*****************************************************************************
+//
+// Ik_Crc16 / Ik_Crc32: CRC-16 (reflected 0x8005, as driverlib's Crc16) and
+// CRC-32 (reflected 0x04C11DB7, as driverlib's Crc32, no inversion inside)
+//
+//*****************************************************************************
+
+static uint32_t IkCrc32Table[256];
+static uint16_t IkCrc16Table[256];
+static bool IkTablesReady = false;
+
+static void Ik_CrcTables(void)
+{
+    uint32_t i, Bit, C32;
+    uint16_t C16;
+
+    for (i = 0; i < 256; i++)
+    {
+        C32 = i;
+        C16 = (uint16_t)i;
+        for (Bit = 0; Bit < 8; Bit++)
+        {
+            C32 = (C32 >> 1) ^ ((C32 & 1) ? 0xEDB88320 : 0);
+            C16 = (uint16_t)((C16 >> 1) ^ ((C16 & 1) ? 0xA001 : 0));
+        }
+        IkCrc32Table[i] = C32;
+        IkCrc16Table[i] = C16;
+    }
+    IkTablesReady = true;
+}
+
+uint16_t Ik_Crc16(uint16_t Crc, const uint8_t *Data, size_t Len)
+{
+    if (!IkTablesReady)
+        Ik_CrcTables();
+    while (Len--)
+        Crc = (uint16_t)((Crc >> 8) ^ IkCrc16Table[(uint8_t)(Crc ^ *Data++)]);
+    return Crc;
+}
+
+uint32_t Ik_Crc32(uint32_t Crc, const uint8_t *Data, size_t Len)
+{
+    if (!IkTablesReady)
+        Ik_CrcTables();
+    while (Len--)
+        Crc = (Crc >> 8) ^ IkCrc32Table[(uint8_t)(Crc ^ *Data++)];
+    return Crc;
+}
+
+//*****************************************************************************
+//
+// Ik_HalfInit / Ik_HalfExpand / Ik_HalfFeed: The halfword stream; a keyframe
+// is a raw sample, a tagged halfword one to four zigzag deltas (first in the
+// low bits), or in a Rice session 14 bits of the Rice stream, which expand to
+// the codes they complete (up to IK_HALF_MAX_OUT samples); with Records set,
+// marker halfwords start session and stamp records (reported once complete),
+// and pads and unknown markers are skipped; the samples of an 8-bit session
+// (or stream frame) are shifted up by Shift to 12 bits
+//
+//*****************************************************************************
+
+static void Ik_RiceKey(ik_half_t *Dec)
+{
+    Dec->RiceBits = 0;
+    Dec->RiceK = IK_RICE_K_START;
+    Dec->RiceSum = 0;
+    Dec->RiceCount = 0;
+}
+
+static size_t Ik_RiceExpand(ik_half_t *Dec, uint16_t Half, uint16_t *Out)
+{
+    uint32_t Ones, Zig, Mean, Need, Bits;
+    size_t Count = 0;
+
+    Dec->RiceAcc = (Dec->RiceAcc << IK_RICE_BITS) | (Half & ((1u << IK_RICE_BITS) - 1));
+    Dec->RiceBits += IK_RICE_BITS;
+    for (;;)
+    {
+        // The quotient is the run of ones at the top of the bits held
+        for (Ones = 0; Ones < Dec->RiceBits && Ones < IK_RICE_ESC &&
+             ((Dec->RiceAcc >> (Dec->RiceBits - 1 - Ones)) & 1); Ones++);
+        if (Ones == IK_RICE_ESC)
+        {
+            Need = IK_RICE_ESC + IK_RICE_RAW_BITS;
+            Bits = IK_RICE_RAW_BITS;
+        }
+        else
+        {
+            Need = Ones + 1 + Dec->RiceK;
+            Bits = Dec->RiceK;
+        }
+        if (Ones == Dec->RiceBits || Dec->RiceBits < Need)
+            return Count;
+
+        Dec->RiceBits -= Need;
+        Zig = (uint32_t)(Dec->RiceAcc >> Dec->RiceBits) & ((1u << Bits) - 1);
+        if (Ones < IK_RICE_ESC)
+            Zig |= Ones << Dec->RiceK;
+        Dec->Prev = (uint16_t)(Dec->Prev + ((Zig >> 1) ^ -(Zig & 1)));
+        Out[Count++] = (uint16_t)((Dec->Prev & IK_SAMPLE_MASK) << Dec->Shift);
+
+        Dec->RiceSum += Zig;
+        if (++Dec->RiceCount == IK_RICE_BLOCK)
+        {
+            Mean = Dec->RiceSum / IK_RICE_BLOCK;
+            for (Dec->RiceK = 0; Dec->RiceK < IK_RICE_K_MAX && (Mean >> (Dec->RiceK + 1)); Dec->RiceK++);
+            Dec->RiceSum = 0;
+            Dec->RiceCount = 0;
+        }
+    }
+}
+
+void Ik_HalfInit(ik_half_t *Dec, bool Delta, bool Records)
+{
+    memset(Dec, 0, sizeof(*Dec));
+    Dec->Delta = Delta;
+    Dec->Records = Records;
+}
+
+size_t Ik_HalfExpand(ik_half_t *Dec, uint16_t Half, uint16_t *Out)
+{
+    uint32_t Count, Bits, Max, Zig, i;
+
+    if (Dec->Rice && (Half & IK_RICE_TAG))
+        return Ik_RiceExpand(Dec, Half, Out);
+    if (!Dec->Delta || (Half & (IK_DELTA_TAG_QUAD | IK_DELTA_TAG_PAIR)) == 0)
+    {
+        Dec->Prev = Half & IK_SAMPLE_MASK;
+        Out[0] = (uint16_t)(Dec->Prev << Dec->Shift);
+        Ik_RiceKey(Dec);
+        return 1;
+    }
+
+    if (Half & IK_DELTA_TAG_QUAD)
+    {
+        Count = ((Half >> 12) & 3) + 1;
+        Bits = 3;
+        Max = 0x07;
+    }
+    else
+    {
+        Count = ((Half >> 12) & 1) + 1;
+        Bits = 6;
+        Max = 0x3F;
+    }
+    for (i = 0; i < Count; i++)
+    {
+        Zig = (Half >> (i * Bits)) & Max;
+        Dec->Prev = (uint16_t)(Dec->Prev + ((Zig >> 1) ^ -(Zig & 1)));
+        Out[i] = (uint16_t)((Dec->Prev & IK_SAMPLE_MASK) << Dec->Shift);
+    }
+    return Count;
+}
+
+static void Ik_HalfRecord(ik_half_t *Dec, const ik_events_t *Ev)
+{
+    uint32_t Header;
+    uint32_t Pos;
+    uint64_t Ticks;
+
+    if (Dec->Record[0] == IK_SESSION_MARKER)
+    {
+        Header = Dec->Record[1] | ((uint32_t)Dec->Record[2] << 16);
+        Dec->Rice = (Header & IK_SESSION_HDR_RICE) != 0;
+        Dec->Delta = Dec->Rice || (Header & IK_SESSION_HDR_DELTA) != 0;
+        Dec->Shift = (Header & IK_SESSION_HDR_8BIT) ? IK_SAMPLE_8BIT_SHIFT : 0;
+        Dec->Sessions++;
+        if (Ev && Ev->Session)
+            Ev->Session(Ev->Ctx, Header);
+    }
+    else if (Dec->Record[0] == IK_ANGLE_MARKER)
+    {
+        Pos = ((uint32_t)(Dec->Record[1] & IK_EVENT_PART_MASK) << 14) | (Dec->Record[2] & IK_EVENT_PART_MASK);
+        if (Ev && Ev->Angle)
+            Ev->Angle(Ev->Ctx, Pos & (IK_ANGLE_DIR_BIT - 1), (Pos & IK_ANGLE_DIR_BIT) != 0);
+    }
+    else if (Dec->Record[0] == IK_RATE_MARKER)
+    {
+        Dec->Rate = ((uint32_t)(Dec->Record[1] & IK_EVENT_PART_MASK) << 14) |
+                    (Dec->Record[2] & IK_EVENT_PART_MASK);
+        if (Ev && Ev->Rate)
+            Ev->Rate(Ev->Ctx, Dec->Rate);
+    }
+    else if ((Dec->Record[0] & IK_EVENT_MARKER_MASK) == IK_EVENT_MARKER)
+    {
+        Ticks = ((uint64_t)(Dec->Record[3] & 0xFF) << 56) |
+                ((uint64_t)(Dec->Record[4] & IK_EVENT_PART_MASK) << 42) |
+                ((uint64_t)(Dec->Record[5] & IK_EVENT_PART_MASK) << 28) |
+                ((uint64_t)(Dec->Record[6] & IK_EVENT_PART_MASK) << 14) |
+                (Dec->Record[7] & IK_EVENT_PART_MASK);
+        Dec->Events++;
+        if (Ev && Ev->Event)
+            Ev->Event(Ev->Ctx, Dec->Record[0] & ~IK_EVENT_MARKER_MASK, Ticks,
+                      Dec->Record[2] & IK_EVENT_PART_MASK, Dec->Record[1] & IK_SAMPLE_MASK);
+    }
+    else
+    {
+        Ticks = ((uint64_t)Dec->Record[2] << 48) | ((uint64_t)Dec->Record[3] << 32) |
+                ((uint64_t)Dec->Record[4] << 16) | Dec->Record[5];
+        if (Ev && Ev->Stamp)
+            Ev->Stamp(Ev->Ctx, Ticks, Dec->Record[1]);
+    }
+}
+
+void Ik_HalfFeed(ik_half_t *Dec, const uint16_t *Half, size_t Count, const ik_events_t *Ev)
+{
+    uint16_t Batch[IK_BATCH + IK_HALF_MAX_OUT];
+    size_t Pending = 0, i;
+
+    for (i = 0; i < Count; i++)
+    {
+        if (Dec->RecordLen)
+        {
+            Dec->Record[Dec->RecordLen++] = Half[i];
+            if (Dec->RecordLen == Dec->RecordSize)
+            {
+                // Samples before the record are reported before it
+                if (Pending && Ev && Ev->Samples)
+                    Ev->Samples(Ev->Ctx, Batch, Pending, false);
+                Dec->Samples += Pending;
+                Pending = 0;
+                Ik_HalfRecord(Dec, Ev);
+                Dec->RecordLen = 0;
+            }
+            continue;
+        }
+        if (Dec->Records && (Half[i] & IK_RECORD_MARKER_BIT))
+        {
+            // A quality record is one halfword and applies to the next sample
+            if ((Half[i] & IK_QUAL_MARKER_MASK) == IK_QUAL_MARKER)
+            {
+                if (Pending && Ev && Ev->Samples)
+                    Ev->Samples(Ev->Ctx, Batch, Pending, false);
+                Dec->Samples += Pending;
+                Pending = 0;
+                Dec->Qualities++;
+                if (Ev && Ev->Quality)
+                    Ev->Quality(Ev->Ctx, Half[i] & ~IK_QUAL_MARKER_MASK);
+                continue;
+            }
+
+            // Pads and unknown records are one halfword
+            if (Half[i] == IK_SESSION_MARKER || Half[i] == IK_STAMP_MARKER || Half[i] == IK_RATE_MARKER ||
+                Half[i] == IK_ANGLE_MARKER || (Half[i] & IK_EVENT_MARKER_MASK) == IK_EVENT_MARKER)
+            {
+                Dec->Record[0] = Half[i];
+                Dec->RecordLen = 1;
+                Dec->RecordSize = (Half[i] == IK_SESSION_MARKER) ? IK_SESSION_RECORD_SIZE :
+                                  (Half[i] == IK_STAMP_MARKER) ? IK_STAMP_RECORD_SIZE :
+                                  (Half[i] == IK_RATE_MARKER) ? IK_RATE_RECORD_SIZE :
+                                  (Half[i] == IK_ANGLE_MARKER) ? IK_ANGLE_RECORD_SIZE : IK_EVENT_RECORD_SIZE;
+            }
+            continue;
+        }
+
+        Pending += Ik_HalfExpand(Dec, Half[i], Batch + Pending);
+        if (Pending >= IK_BATCH)
+        {
+            if (Ev && Ev->Samples)
+                Ev->Samples(Ev->Ctx, Batch, Pending, false);
+            Dec->Samples += Pending;
+            Pending = 0;
+        }
+    }
+
+    if (Pending && Ev && Ev->Samples)
+        Ev->Samples(Ev->Ctx, Batch, Pending, false);
+    Dec->Samples += Pending;
+}
+
+//*****************************************************************************
+//
+// Ik_LogInit / Ik_LogPage / Ik_LogBlock: Decode log pages in order; a page
+// that fails its header or seal is skipped and breaks off any record in
+// progress; a page still being filled (erased seal) is decoded up to its
+// erased tail, which reads as pads. Ik_LogBlock reads just the block header,
+// for a reader seeking to a page: its session's codec, channels, rate and
+// time base
+//
+// \return IK_OK, IK_PAGE_OPEN, IK_ERR_FORMAT (no page header or another
+// version) or IK_ERR_CRC
+//
+//*****************************************************************************
+
+void Ik_LogInit(ik_log_t *Log)
+{
+    memset(Log, 0, sizeof(*Log));
+    Ik_HalfInit(&Log->Half, false, true);
+}
+
+static uint32_t Ik_Le32(const uint8_t *p)
+{
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t Ik_Be32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+int Ik_LogBlock(const uint8_t *Page, ik_block_t *Block)
+{
+    uint32_t Word1 = Ik_Le32(Page + 4);
+
+    if ((Ik_Le32(Page) >> 24) != IK_LOG_PAGE_MAGIC || (Word1 >> 24) != IK_LOG_BLOCK_VERSION)
+        return IK_ERR_FORMAT;
+    if ((Ik_Crc32(0xFFFFFFFF, Page, IK_LOG_HDR_WORDS * 4 - 4) ^ 0xFFFFFFFF) !=
+        Ik_Le32(Page + IK_LOG_HDR_WORDS * 4 - 4))
+        return IK_ERR_CRC;
+
+    Block->Seq = Ik_Le32(Page) & IK_LOG_SEQ_MASK;
+    Block->Codec = (uint8_t)(Word1 >> 8);
+    Block->Channels = (uint8_t)Word1;
+    Block->ChannelMask = Ik_Le32(Page + 8);
+    Block->Rate = Ik_Le32(Page + 12);
+    Block->Stamp = ((uint64_t)Ik_Le32(Page + 16) << 32) | Ik_Le32(Page + 20);
+    Block->SessionBytes = Ik_Le32(Page + 24);
+    Block->SeekMs = Ik_Le32(Page + 28);
+    Block->SeekAddr = Ik_Le32(Page + 32);
+    return IK_OK;
+}
+
+int Ik_LogPage(ik_log_t *Log, const uint8_t *Page, size_t PageSize, const ik_events_t *Ev)
+{
+    uint16_t Half[2048];
+    uint32_t Header = Ik_Le32(Page);
+    uint32_t Seal = Ik_Le32(Page + PageSize - 4);
+    size_t Count = 0, Off;
+    bool Open = Seal == 0xFFFFFFFF;
+    int Result = Ik_LogBlock(Page, &Log->Block);
+
+    Log->Pages++;
+    if (Result == IK_OK && !Open && (Ik_Crc32(0xFFFFFFFF, Page, PageSize - 4) ^ 0xFFFFFFFF) != Seal)
+        Result = IK_ERR_CRC;
+    if (Result != IK_OK)
+    {
+        Log->BadPages++;
+        Log->Half.RecordLen = 0;
+        return Result;
+    }
+
+    if (Log->HaveSeq && ((Log->LastSeq + 1) & IK_LOG_SEQ_MASK) != (Header & IK_LOG_SEQ_MASK))
+    {
+        Log->SeqGaps++;
+        Log->Half.RecordLen = 0;
+    }
+    Log->LastSeq = Header & IK_LOG_SEQ_MASK;
+    Log->HaveSeq = true;
+
+    for (Off = IK_LOG_HDR_WORDS * 4; Off < PageSize - 4; Off += 2)
+    {
+        Half[Count++] = (uint16_t)(Page[Off] | (Page[Off + 1] << 8));
+        if (Count == sizeof(Half) / sizeof(Half[0]))
+        {
+            Ik_HalfFeed(&Log->Half, Half, Count, Ev);
+            Count = 0;
+        }
+    }
+    Ik_HalfFeed(&Log->Half, Half, Count, Ev);
+
+    return Open ? IK_PAGE_OPEN : IK_OK;
+}
+
+//*****************************************************************************
+//
+// Ik_Payload: Decodes the payload of a stream frame or packet, Count samples
+// (or halfwords when delta compressed, the first a keyframe, or when in units,
+// two a sample), most significant byte first; the UART and USB codec flags
+// share their bit values. With IK_UART_8BIT the samples are 8 bits, shifted
+// up to 12: a raw payload has two a halfword (one in the last with
+// IK_UART_ODD), a delta payload codes the 8-bit values
+//
+//*****************************************************************************
+
+static size_t Ik_Payload(const uint8_t *p, size_t Count, uint8_t Flags, bool Lost, const ik_events_t *Ev)
+{
+    uint16_t Out[255 * 4];
+    float Kpa[255 / 2];
+    ik_half_t Dec;
+    size_t Samples = 0, i;
+    uint32_t Word;
+    float Value;
+
+    if (Flags & IK_UART_UNITS)
+    {
+        for (i = 0; i + 1 < Count && i < 255; i += 2, Samples++)
+        {
+            Word = ((uint32_t)p[i * 2] << 24) | ((uint32_t)p[i * 2 + 1] << 16) |
+                   ((uint32_t)p[i * 2 + 2] << 8) | p[i * 2 + 3];
+            if (Flags & IK_UART_FLOAT)
+                memcpy(&Value, &Word, sizeof(Value));
+            else
+                Value = (float)(int32_t)Word / 1000.0f;
+            Kpa[Samples] = Value;
+        }
+        if (Samples && Ev && Ev->Pressure)
+            Ev->Pressure(Ev->Ctx, Kpa, Samples, Lost);
+        return Samples;
+    }
+
+    if ((Flags & (IK_UART_8BIT | IK_UART_DELTA)) == IK_UART_8BIT)
+    {
+        for (i = 0; i < Count && i < 255; i++)
+        {
+            Out[Samples++] = (uint16_t)(p[i * 2] << IK_SAMPLE_8BIT_SHIFT);
+            if (i + 1 < Count || !(Flags & IK_UART_ODD))
+                Out[Samples++] = (uint16_t)(p[i * 2 + 1] << IK_SAMPLE_8BIT_SHIFT);
+        }
+        if (Samples && Ev && Ev->Samples)
+            Ev->Samples(Ev->Ctx, Out, Samples, Lost);
+        return Samples;
+    }
+
+    Ik_HalfInit(&Dec, (Flags & IK_UART_DELTA) != 0, false);
+    if (Flags & IK_UART_8BIT)
+        Dec.Shift = IK_SAMPLE_8BIT_SHIFT;
+    for (i = 0; i < Count && i < 255; i++)
+        Samples += Ik_HalfExpand(&Dec, (uint16_t)((p[i * 2] << 8) | p[i * 2 + 1]), Out + Samples);
+    if (Samples && Ev && Ev->Samples)
+        Ev->Samples(Ev->Ctx, Out, Samples, Lost);
+    return Samples;
+}
+
+//*****************************************************************************
+//
+// Ik_UartInit / Ik_UartFeed: The UART0 and virtual COM port frame stream
+//
+//*****************************************************************************
+
+void Ik_UartInit(ik_uart_t *Dec)
+{
+    memset(Dec, 0, sizeof(*Dec));
+}
+
+static void Ik_UartDrop(ik_uart_t *Dec, size_t Len, bool Skipped)
+{
+    memmove(Dec->Buf, Dec->Buf + Len, Dec->Len - Len);
+    Dec->Len -= Len;
+    if (Skipped)
+        Dec->SkippedBytes += Len;
+}
+
+void Ik_UartFeed(ik_uart_t *Dec, const uint8_t *Data, size_t Len, const ik_events_t *Ev)
+{
+    size_t Take, Frame, i;
+    uint16_t Crc;
+    uint32_t Seq;
+    bool Lost;
+
+    while (Len || Dec->Len >= IK_UART_HEADER)
+    {
+        Take = sizeof(Dec->Buf) - Dec->Len;
+        if (Take > Len)
+            Take = Len;
+        memcpy(Dec->Buf + Dec->Len, Data, Take);
+        Dec->Len += Take;
+        Data += Take;
+        Len -= Take;
+
+        // Find the sync bytes
+        for (i = 0; i + 1 < Dec->Len && !(Dec->Buf[i] == IK_UART_SYNC0 && Dec->Buf[i + 1] == IK_UART_SYNC1); i++);
+        if (i)
+            Ik_UartDrop(Dec, i, true);
+        if (Dec->Len < IK_UART_HEADER)
+        {
+            if (Len == 0)
+                return;
+            continue;
+        }
+
+        Frame = IK_UART_HEADER + Dec->Buf[4] * 2 + 2;
+        if (Dec->Len < Frame)
+        {
+            if (Len == 0)
+                return;
+            continue;
+        }
+
+        Crc = Ik_Crc16(0, Dec->Buf + 2, Frame - 4);
+        if (Crc != ((Dec->Buf[Frame - 2] << 8) | Dec->Buf[Frame - 1]))
+        {
+            Dec->CrcErrors++;
+            Ik_UartDrop(Dec, 1, true);
+            continue;
+        }
+
+        Seq = (Dec->Buf[2] << 8) | Dec->Buf[3];
+        Lost = (Dec->Buf[5] & IK_UART_LOST) != 0;
+        if (Dec->HaveSeq && Seq != Dec->NextSeq)
+        {
+            Dec->SeqGaps++;
+            Lost = true;
+        }
+        Dec->NextSeq = (Seq + 1) & 0xFFFF;
+        Dec->HaveSeq = true;
+        if (Dec->Buf[5] & IK_UART_LOST)
+            Dec->LostFlags++;
+        if (Dec->Buf[5] & IK_UART_QUALITY)
+            Dec->QualityFlags++;
+
+        Dec->Samples += Ik_Payload(Dec->Buf + IK_UART_HEADER, Dec->Buf[4], Dec->Buf[5], Lost, Ev);
+        Dec->Frames++;
+        Ik_UartDrop(Dec, Frame, false);
+    }
+}
+
+//*****************************************************************************
+//
+// Ik_UsbInit / Ik_UsbPacket: USB bulk IN packets
+//
+// \return IK_OK, IK_DONE (an END packet whose CRC32 matched), IK_ERR_CRC or
+// IK_ERR_FORMAT
+//
+//*****************************************************************************
+
+void Ik_UsbInit(ik_usb_t *Dec)
+{
+    memset(Dec, 0, sizeof(*Dec));
+    Dec->RangeCrc = 0xFFFFFFFF;
+}
+
+int Ik_UsbPacket(ik_usb_t *Dec, const uint8_t *Pkt, size_t Len, const ik_events_t *Ev)
+{
+    uint32_t Words[(IK_USB_PKT_SIZE - IK_USB_PKT_HEADER) / 4];
+    size_t Count, i;
+    bool Lost, Ok;
+
+    if (Len < IK_USB_PKT_HEADER || Len > IK_USB_PKT_SIZE)
+        return IK_ERR_FORMAT;
+    Dec->Packets++;
+    Count = Pkt[2];
+
+    switch (Pkt[0])
+    {
+        case IK_USB_PKT_REPLY:
+            if (IK_USB_PKT_HEADER + Count * 4 > Len)
+                return IK_ERR_FORMAT;
+            for (i = 0; i < Count; i++)
+                Words[i] = Ik_Be32(Pkt + IK_USB_PKT_HEADER + i * 4);
+            if (Dec->Reply)
+                Dec->Reply(Ev ? Ev->Ctx : 0, Pkt[1], Words, Count);
+            return IK_OK;
+
+        case IK_USB_PKT_DATA:
+            if (IK_USB_PKT_HEADER + Count > Len)
+                return IK_ERR_FORMAT;
+            if (Pkt[1] != Dec->NextDataSeq)
+                Dec->RangeErrors++;
+            Dec->NextDataSeq = (uint8_t)(Pkt[1] + 1);
+            Dec->RangeCrc = Ik_Crc32(Dec->RangeCrc, Pkt + IK_USB_PKT_HEADER, Count);
+            Dec->DataBytes += Count;
+            if (Dec->Data)
+                Dec->Data(Ev ? Ev->Ctx : 0, Pkt + IK_USB_PKT_HEADER, Count);
+            return IK_OK;
+
+        case IK_USB_PKT_END:
+            if (Len < IK_USB_PKT_HEADER + 4)
+                return IK_ERR_FORMAT;
+            Ok = Pkt[1] == Dec->NextDataSeq &&
+                 (Dec->RangeCrc ^ 0xFFFFFFFF) == Ik_Be32(Pkt + IK_USB_PKT_HEADER);
+            if (!Ok)
+                Dec->RangeErrors++;
+            Dec->RangeCrc = 0xFFFFFFFF;
+            Dec->NextDataSeq = 0;
+            return Ok ? IK_DONE : IK_ERR_CRC;
+
+        case IK_USB_PKT_STREAM:
+            if (IK_USB_PKT_HEADER + Count * 2 > Len)
+                return IK_ERR_FORMAT;
+            Lost = (Pkt[3] & IK_USB_STREAM_LOST) != 0;
+            if (Lost)
+                Dec->LostFlags++;
+            if (Pkt[3] & IK_USB_STREAM_QUALITY)
+                Dec->QualityFlags++;
+            if (Dec->HaveStreamSeq && Pkt[1] != Dec->NextStreamSeq)
+            {
+                Dec->SeqGaps++;
+                Lost = true;
+            }
+            Dec->NextStreamSeq = (uint8_t)(Pkt[1] + 1);
+            Dec->HaveStreamSeq = true;
+            Dec->Samples += Ik_Payload(Pkt + IK_USB_PKT_HEADER, Count, Pkt[3], Lost, Ev);
+            return IK_OK;
+    }
+
+    return IK_ERR_FORMAT;
+}
+
+//*****************************************************************************
+//
+// Ik_CanInit / Ik_CanFrame: CAN frames from the unit
+//
+// \param Page - Buffer of the log page size for bulk dump pages (0 = none)
+// \param Xfer - Buffer for ISO-TP transfers (0 = none)
+//
+// \return IK_OK, IK_MORE (an ISO-TP transfer continues; after a first frame,
+// send FlowControl), IK_DONE (an ISO-TP transfer is complete in Xfer, XferLen
+// bytes), IK_ERR_CRC (a bulk window or page failed its trailer) or IK_ERR_FORMAT (not a
+// frame the decoder knows, or an ISO-TP transfer broken off)
+//
+//*****************************************************************************
+
+void Ik_CanInit(ik_can_t *Dec, uint8_t *Page, size_t PageSize, uint8_t *Xfer, size_t XferSize)
+{
+    void (*BulkPage)(void *, uint32_t, const uint8_t *, size_t, bool) = Dec->BulkPage;
+    void (*BulkWindow)(void *, uint32_t, const uint8_t *, size_t, bool, bool) = Dec->BulkWindow;
+
+    memset(Dec, 0, sizeof(*Dec));
+    Dec->BulkPage = BulkPage;
+    Dec->BulkWindow = BulkWindow;
+    Dec->Page = Page;
+    Dec->PageSize = PageSize;
+    Dec->PageCrc = 0xFFFFFFFF;
+    Dec->Xfer = Xfer;
+    Dec->XferSize = XferSize;
+}
+
+static int Ik_CanIsoTp(ik_can_t *Dec, const uint8_t *Data, size_t Dlc)
+{
+    size_t Len, Off, Run;
+
+    switch (Data[0] & 0xF0)
+    {
+        case 0x00:
+            Len = Data[0] & 0x0F;
+            if (Len > 7 || Len + 1 > Dlc || Len > Dec->XferSize)
+                return IK_ERR_FORMAT;
+            memcpy(Dec->Xfer, Data + 1, Len);
+            Dec->XferLen = Len;
+            Dec->XferGot = Len;
+            return IK_DONE;
+
+        case 0x10:
+            Len = ((Data[0] & 0x0F) << 8) | Data[1];
+            Off = 2;
+            if (Len == 0)
+            {
+                Len = Ik_Be32(Data + 2);
+                Off = 6;
+            }
+            memset(Dec->FlowControl, 0, sizeof(Dec->FlowControl));
+            if (Len > Dec->XferSize)
+            {
+                // Overflow: the unit aborts the transfer
+                Dec->FlowControl[0] = 0x32;
+                Dec->XferErrors++;
+                Dec->XferLen = 0;
+                return IK_MORE;
+            }
+            Dec->XferLen = Len;
+            Dec->XferGot = Dlc - Off;
+            memcpy(Dec->Xfer, Data + Off, Dlc - Off);
+            Dec->XferSN = 1;
+            Dec->FlowControl[0] = 0x30;  // Continue to send, no block limit, no separation time
+            return IK_MORE;
+
+        case 0x20:
+            if (Dec->XferLen == 0 || Dec->XferGot >= Dec->XferLen)
+                return IK_ERR_FORMAT;
+            if ((Data[0] & 0x0F) != Dec->XferSN)
+            {
+                Dec->XferErrors++;
+                Dec->XferLen = 0;
+                return IK_ERR_FORMAT;
+            }
+            Dec->XferSN = (Dec->XferSN + 1) & 0x0F;
+            Run = Dec->XferLen - Dec->XferGot;
+            if (Run > 7) Run = 7;
+            if (Run > Dlc - 1) Run = Dlc - 1;
+            memcpy(Dec->Xfer + Dec->XferGot, Data + 1, Run);
+            Dec->XferGot += Run;
+            return (Dec->XferGot >= Dec->XferLen) ? IK_DONE : IK_MORE;
+    }
+
+    return IK_ERR_FORMAT;
+}
+
+int Ik_CanFrame(ik_can_t *Dec, uint32_t Id, bool Extended, const uint8_t *Data, size_t Dlc,
+                const ik_events_t *Ev)
+{
+    uint16_t Samples[3];
+    uint32_t Seq, Addr, Crc;
+    size_t Count, i;
+    bool Lost, Ok, Resent;
+
+    if (Dlc == 0 || Dlc > 8)
+        return IK_ERR_FORMAT;
+    Dec->Frames++;
+    Dec->Bytes += Dlc;
+
+    if (!Extended && Id == IK_CAN_STREAM_ID && Dlc >= 2)
+    {
+        Count = Data[1] & 0x7F;
+        Lost = (Data[1] & IK_CAN_STREAM_LOST) != 0;
+        if (Lost)
+            Dec->LostFlags++;
+        if (Dec->HaveStreamSeq && Data[0] != Dec->NextStreamSeq)
+        {
+            Dec->SeqGaps++;
+            Lost = true;
+        }
+        Dec->NextStreamSeq = (uint8_t)(Data[0] + 1);
+        Dec->HaveStreamSeq = true;
+        for (i = 0; i < Count && i < 3 && 3 + i * 2 < Dlc; i++)
+            Samples[i] = (uint16_t)((Data[2 + i * 2] << 8) | Data[3 + i * 2]);
+        Dec->Samples += i;
+        if (i && Ev && Ev->Samples)
+            Ev->Samples(Ev->Ctx, Samples, i, Lost);
+        return IK_OK;
+    }
+
+    if (!Extended && Id == IK_CAN_ALARM_ID && Dlc == 8)
+    {
+        Dec->Alarms++;
+        if (Dec->HaveAlarmSeq && Data[0] != Dec->NextAlarmSeq)
+            Dec->AlarmGaps++;
+        Dec->NextAlarmSeq = (uint8_t)(Data[0] + 1);
+        Dec->HaveAlarmSeq = true;
+        if (Ev && Ev->Alarm)
+            Ev->Alarm(Ev->Ctx, Data[1] & 0x0F, Data[1] & 0xF0, Data[2], (uint16_t)((Data[3] << 8) | Data[4]),
+                      (int16_t)((Data[5] << 8) | Data[6]));
+        return IK_OK;
+    }
+
+    if (!Extended && Id == IK_CAN_RBE_ID && Dlc == 8)
+    {
+        Dec->Reports++;
+        if (Dec->HaveReportSeq && Data[0] != Dec->NextReportSeq)
+            Dec->ReportGaps++;
+        Dec->NextReportSeq = (uint8_t)(Data[0] + 1);
+        Dec->HaveReportSeq = true;
+        if (Ev && Ev->Report)
+            Ev->Report(Ev->Ctx, Data[1] & 0x0F, (uint16_t)((Data[2] << 8) | Data[3]), Ik_Be32(Data + 4),
+                       (Data[1] & IK_RBE_KEEPALIVE) != 0);
+        return IK_OK;
+    }
+
+    if (Extended && (Id & ~0x1FFFFu) == IK_CAN_BULK_ID_BASE)
+    {
+        Seq = Id & 0xFFFF;
+        if (Dec->HaveBulkSeq && Seq != Dec->NextBulkSeq)
+            Dec->SeqGaps++;
+        Dec->NextBulkSeq = (uint16_t)(Seq + 1);
+        Dec->HaveBulkSeq = true;
+
+        if ((Id & IK_CAN_BULK_TRAILER) && Dlc == IK_BULK_WIN_LEN)
+        {
+            // A re-sent or acknowledged dump window stands alone, outside any page
+            Addr = ((uint32_t)Data[1] << 16) | (Data[2] << 8) | Data[3];
+            Resent = (Data[0] & IK_BULK_WIN_RESENT) != 0;
+            Ok = Dec->WinLen == IK_BULK_WINDOW && Dec->WinCrc == ((Data[4] << 8) | Data[5]);
+            if (!Ok)
+                Dec->BadWindows++;
+            if (Dec->BulkWindow && Dec->Page && Dec->PageLen >= Dec->WinLen && Dec->PageLen <= Dec->PageSize)
+                Dec->BulkWindow(Ev ? Ev->Ctx : 0, Addr, Dec->Page + Dec->PageLen - Dec->WinLen, Dec->WinLen,
+                                Ok, Resent);
+            if (Data[0] & (IK_BULK_WIN_RESENT | IK_BULK_WIN_ARQ))
+            {
+                Dec->PageLen = 0;
+                Dec->PageCrc = 0xFFFFFFFF;
+            }
+            Dec->WinLen = 0;
+            Dec->WinCrc = 0;
+            return Ok ? IK_OK : IK_ERR_CRC;
+        }
+
+        if (Id & IK_CAN_BULK_TRAILER)
+        {
+            Addr = Ik_Be32(Data);
+            Crc = Ik_Be32(Data + 4);
+            Ok = Dec->PageLen == Dec->PageSize && (Dec->PageCrc ^ 0xFFFFFFFF) == Crc;
+            if (!Ok)
+                Dec->BadPages++;
+            if (Dec->BulkPage && Dec->Page)
+                Dec->BulkPage(Ev ? Ev->Ctx : 0, Addr, Dec->Page, Dec->PageLen, Ok);
+            Dec->PageLen = 0;
+            Dec->PageCrc = 0xFFFFFFFF;
+            Dec->WinLen = 0;
+            Dec->WinCrc = 0;
+            return Ok ? IK_OK : IK_ERR_CRC;
+        }
+
+        Dec->WinCrc = Ik_Crc16(Dec->WinCrc, Data, Dlc);
+        Dec->WinLen += Dlc;
+        Dec->PageCrc = Ik_Crc32(Dec->PageCrc, Data, Dlc);
+        if (Dec->Page && Dec->PageLen + Dlc <= Dec->PageSize)
+            memcpy(Dec->Page + Dec->PageLen, Data, Dlc);
+        Dec->PageLen += Dlc;
+        return IK_OK;
+    }
+
+    if (!Extended && Id == IK_ISOTP_TX_ID && Dec->Xfer)
+        return Ik_CanIsoTp(Dec, Data, Dlc);
+
+    return IK_ERR_FORMAT;
+}
+
+//*****************************************************************************
+//
+// Ik_SuiteParse / Ik_SuiteName / Ik_SuiteUnit / Ik_SuiteHigherBetter /
+// Ik_SuiteDiff: Benchmark suite records (see ikdecode.h)
+//
+//*****************************************************************************
+
+static const struct {
+    const char *Name;
+    const char *Unit;
+    bool HigherBetter;
+} IkSuiteField[IK_SUITE_FIELDS] = {
+    {"lat_p50",      "cycles",      false},
+    {"lat_p99",      "cycles",      false},
+    {"e2e_p99",      "cycles",      false},
+    {"jit_rms",      "cycles",      false},
+    {"jit_peak",     "cycles",      false},
+    {"kb_push_pop",  "cycles/100",  false},
+    {"kb_reader",    "cycles/100",  false},
+    {"kb_crc32",     "cycles/100",  false},
+    {"flash_read",   "B/s",         true},
+    {"can_bulk",     "B/s",         true},
+    {"can_cycles",   "cycles",      false},
+    {"usb_bulk",     "B/s",         true},
+    {"idle",         "1/1000",      true}
+};
+
+int Ik_SuiteParse(ik_suite_t *Rec, const uint32_t *Words, size_t Count)
+{
+    size_t Fields, i;
+
+    if (Count < 2 || (Words[0] >> 16) != IK_SUITE_MAGIC)
+        return IK_ERR_FORMAT;
+
+    Fields = Words[0] & 0xFF;
+    if (Fields > Count - 2)
+        Fields = Count - 2;
+    Rec->State = (Words[0] >> 8) & 0xFF;
+    Rec->Build = Words[1];
+    for (i = 0; i < IK_SUITE_FIELDS; i++)
+        Rec->Value[i] = (i < Fields) ? Words[2 + i] : IK_SUITE_NONE;
+    return IK_OK;
+}
+
+const char *Ik_SuiteName(uint32_t Field)
+{
+    return (Field < IK_SUITE_FIELDS) ? IkSuiteField[Field].Name : "?";
+}
+
+const char *Ik_SuiteUnit(uint32_t Field)
+{
+    return (Field < IK_SUITE_FIELDS) ? IkSuiteField[Field].Unit : "";
+}
+
+bool Ik_SuiteHigherBetter(uint32_t Field)
+{
+    return Field < IK_SUITE_FIELDS && IkSuiteField[Field].HigherBetter;
+}
+
+int Ik_SuiteDiff(const ik_suite_t *Old, const ik_suite_t *New, uint32_t Field, int32_t *PerMille)
+{
+    int64_t Change;
+
+    if (Field >= IK_SUITE_FIELDS || Old->Value[Field] == IK_SUITE_NONE || New->Value[Field] == IK_SUITE_NONE)
+        return IK_ERR_FORMAT;
+
+    if (Old->Value[Field] == 0)
+        Change = (New->Value[Field] == 0) ? 0 : 1000;
+    else
+        Change = ((int64_t)New->Value[Field] - Old->Value[Field]) * 1000 / Old->Value[Field];
+    if (Change > 1000000)
+        Change = 1000000;
+    *PerMille = (int32_t)(IkSuiteField[Field].HigherBetter ? Change : -Change);
+    return IK_OK;
+}
+
+#endif
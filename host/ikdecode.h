@@ -0,0 +1,391 @@
+//*****************************************************************************
+//
+// ikdecode.h - Host-side decoders for the Inkley_PressureSensor wire and log
+// formats: the flash log pages and the halfword stream of the sessions in
+// them, the UART0 / virtual COM port stream frames, the USB bulk IN packets,
+// and the CAN live stream, bulk dump and ISO-TP frames. Portable C99, no
+// allocation; every constant below mirrors the firmware's settings in main.c
+// and must change with them
+//
+//*****************************************************************************
+
+#ifndef IKDECODE_H
+#define IKDECODE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*****************************************************************************
+//
+// Firmware Constants (main.c)
+//
+//*****************************************************************************
+
+// Log pages and the halfword stream (Flash Log, Sample Compression)
+#define IK_LOG_PAGE_MAGIC      0xA5        // Page header bits 31-24 of a written page
+#define IK_LOG_SEQ_MASK        0x00FFFFFF  // Page header sequence number bits
+#define IK_LOG_BLOCK_VERSION   3           // Block header word 1 bits 31-24
+#define IK_LOG_HDR_WORDS       10          // Words of the block header
+#define IK_LOG_CODEC_DELTA     1           // Block header codec: delta compressed
+#define IK_LOG_CODEC_RICE      2           // Block header codec: Rice coded
+#define IK_LOG_CODEC_8BIT      0x80        // Block header codec bit: 8-bit samples
+#define IK_LOG_SEEK_NONE       0xFFFFFFFF  // Block header seek words: no stamp record before the page
+#define IK_RECORD_MARKER_BIT   0x8000      // Set in every record halfword
+#define IK_SESSION_MARKER      0xB600      // Session record marker
+#define IK_SESSION_RECORD_SIZE 3           // Marker, header word low half, high half
+#define IK_STAMP_MARKER        0xB500      // Stamp record marker
+#define IK_STAMP_RECORD_SIZE   6           // Marker, dropped count, four timestamp halves
+#define IK_EVENT_MARKER        0xB400      // Event record marker (channel in bits 2-0)
+#define IK_EVENT_MARKER_MASK   0xFFF8
+#define IK_EVENT_RECORD_SIZE   8           // Marker, peak, duration, five timestamp parts
+#define IK_EVENT_PART_MASK     0x3FFF      // Bits of a part (the rest is the 0xC000 tag)
+#define IK_RATE_MARKER         0xB300      // Rate record marker
+#define IK_RATE_RECORD_SIZE    3           // Marker, two rate parts (high first)
+#define IK_ANGLE_MARKER        0xB200      // Angle record marker (angle sampling)
+#define IK_ANGLE_RECORD_SIZE   3           // Marker, two position parts (high first)
+#define IK_ANGLE_DIR_BIT       0x08000000  // Angle record: the shaft ran backwards
+#define IK_QUAL_MARKER         0xB100      // Quality record: the one halfword, QUAL_ flags in bits 3-0
+#define IK_QUAL_MARKER_MASK    0xFFF0
+#define IK_QUAL_MISSING        0x01        // No conversion: the previous frame's value
+#define IK_QUAL_SATURATED      0x02        // The input read 0 or full scale
+#define IK_QUAL_REPLACED       0x04        // The median filter replaced the input
+#define IK_QUAL_INTERP         0x08        // A divided channel's value between updates
+#define IK_FLASH_PAD           0xFFFF      // Pad halfword (and erased flash)
+#define IK_SESSION_HDR_MAGIC   0x5C        // Session header bits 31-24
+#define IK_SESSION_HDR_DELTA   0x00800000  // Session header bit: delta compressed
+#define IK_SESSION_HDR_RICE    0x00400000  // Session header bit: Rice coded
+#define IK_SESSION_HDR_8BIT    0x00008000  // Session header bit: 8-bit samples (the top bits of 12)
+#define IK_SESSION_HDR_PAIRED  0x00004000  // Session header bit: interleaved trigger pairs (ADC0 then ADC1), rate twice the trigger rate
+#define IK_SAMPLE_MASK         0x0FFF      // Bits of a sample
+#define IK_SAMPLE_8BIT_SHIFT   4           // Bits an 8-bit sample is shifted up to 12
+#define IK_DELTA_TAG_PAIR      0x2000      // Halfword of one or two 6-bit deltas
+#define IK_DELTA_TAG_QUAD      0x4000      // Halfword of one to four 3-bit deltas
+#define IK_RICE_TAG            0x4000      // Rice session: halfword of 14 stream bits
+#define IK_RICE_BITS           14
+#define IK_RICE_BLOCK          16          // Deltas per block of one k
+#define IK_RICE_K_START        2           // k after a keyframe
+#define IK_RICE_K_MAX          11
+#define IK_RICE_ESC            8           // Quotient from which a delta is stored raw
+#define IK_RICE_RAW_BITS       13
+#define IK_HALF_MAX_OUT        16          // Most samples one halfword expands to
+
+// UART0 and virtual COM port stream frames (UART Streaming Settings)
+#define IK_UART_SYNC0          0xA5
+#define IK_UART_SYNC1          0x5A
+#define IK_UART_HEADER         6           // Sync, sequence count, count, flags
+#define IK_UART_LOST           0x01        // Flags: samples were lost before the frame
+#define IK_UART_DELTA          0x02        // Flags: delta compressed halfwords
+#define IK_UART_UNITS          0x04        // Flags: gauge pressure, two halfwords a sample
+#define IK_UART_FLOAT          0x08        // Flags (with UNITS): float kPa, else int32 Pa
+#define IK_UART_QUALITY        0x10        // Flags: a sample came from a ring block with quality flags
+#define IK_UART_8BIT           0x20        // Flags: 8-bit samples (raw two a halfword, high byte first, or delta coded)
+#define IK_UART_ODD            0x40        // Flags (with 8BIT, raw): the last halfword holds one sample
+#define IK_UART_FRAME_MAX      (IK_UART_HEADER + 255 * 2 + 2)
+
+// USB bulk IN packets (USB Bulk Settings)
+#define IK_USB_PKT_SIZE        64
+#define IK_USB_PKT_HEADER      4
+#define IK_USB_PKT_REPLY       0x01
+#define IK_USB_PKT_DATA        0x02
+#define IK_USB_PKT_END         0x03
+#define IK_USB_PKT_STREAM      0x04
+#define IK_USB_STREAM_LOST     0x01
+#define IK_USB_STREAM_DELTA    0x02
+#define IK_USB_STREAM_UNITS    0x04
+#define IK_USB_STREAM_FLOAT    0x08
+#define IK_USB_STREAM_QUALITY  0x10
+#define IK_USB_STREAM_8BIT     0x20
+#define IK_USB_STREAM_ODD      0x40
+
+// CAN (CAN Settings, Live Streaming Settings, ISO-TP Transport Settings); the
+// IDs of node IK_CAN_NODE_DEF, IK_CAN_NODE_ID gives another node's (CAN Node
+// Addressing Settings)
+#define IK_CAN_NODE_DEF        7           // Node of a unit none was assigned to
+#define IK_CAN_NODE_ID(Id, Node) ((Id) - IK_CAN_NODE_DEF + (Node))  // An ID below at another node
+#define IK_CAN_ID              0x107       // Unit ID (command responses)
+#define IK_CAN_STREAM_ID       0x207       // Live sample frames
+#define IK_CAN_STREAM_LOST     0x80        // Frame byte 1: samples were lost
+#define IK_CAN_ALARM_ID        0x087       // Pressure alarm frames (Pressure Alarm Settings)
+#define IK_ALARM_CAUSE_HIGH    0x10        // Alarm frame byte 1: at or above the high level
+#define IK_ALARM_CAUSE_LOW     0x20        // Alarm frame byte 1: at or below the low level
+#define IK_ALARM_CAUSE_RATE    0x40        // Alarm frame byte 1: rate of change
+#define IK_CAN_RBE_ID          0x307       // Report-by-exception frames (Report by Exception Settings)
+#define IK_RBE_KEEPALIVE       0x80        // Report frame byte 1: a keep-alive, not a change
+#define IK_CAN_BULK_ID_BASE    ((uint32_t)0x787 << 18)  // Bulk dump frames (29-bit IDs): the plan's bulk base 0x780 plus the node, in bits 28-18
+#define IK_CAN_BULK_TRAILER    0x00010000  // Bulk ID bit of a page (8 bytes) or window (6 bytes) trailer frame
+#define IK_BULK_WINDOW         128         // Bytes per bulk window
+#define IK_BULK_WIN_LEN        6           // Bytes of a window trailer frame
+#define IK_BULK_WIN_RESENT     0x01        // Window trailer byte 0: re-sent by icmdFlashBulkResend
+#define IK_BULK_WIN_ARQ        0x02        // Window trailer byte 0: an icmdFlashArqDump window (no page trailer)
+#define IK_ISOTP_TX_ID         0x187       // ISO-TP frames from the unit
+#define IK_ISOTP_RX_ID         0x607       // Flow control frames to the unit
+#define IK_CAN_HB_ID           0x707       // Heartbeat, load, health and buffer event frames
+
+// icmdBenchSuite record (Benchmark Suite Settings): header word, BuildVersion,
+// then the fields in IK_SUITE_* order
+#define IK_SUITE_MAGIC         0x4B42      // Header bits 31-16
+#define IK_SUITE_NONE          0xFFFFFFFF  // A field not measured
+#define IK_SUITE_STATE_NONE    0           // Header bits 15-8: no run since boot
+#define IK_SUITE_STATE_RUN     1           // A run in progress
+#define IK_SUITE_STATE_DONE    2           // The run finished
+#define IK_SUITE_STATE_STOP    3           // The run was stopped
+#define IK_SUITE_LAT_P50       0           // Conversion latency median, cycles
+#define IK_SUITE_LAT_P99       1           // Conversion latency 99th percentile, cycles
+#define IK_SUITE_E2E_P99       2           // Trigger to CAN TX complete 99th percentile, cycles
+#define IK_SUITE_JIT_RMS       3           // Sample interval RMS deviation, cycles
+#define IK_SUITE_JIT_PEAK      4           // Sample interval largest deviation, cycles
+#define IK_SUITE_KB_PUSH_POP   5           // Ring push and pop, cycles per sample in 1/100
+#define IK_SUITE_KB_READER     6           // Ring push and two reader pops, cycles per sample in 1/100
+#define IK_SUITE_KB_CRC32      7           // Crc32, cycles per byte in 1/100
+#define IK_SUITE_FLASH_READ    8           // Log storage read, bytes a second
+#define IK_SUITE_CAN_BULK      9           // CAN bulk dump in loopback, bytes a second
+#define IK_SUITE_CAN_CYCLES    10          // CPU cycles per frame of that run
+#define IK_SUITE_USB_BULK      11          // Last USB bulk run, bytes a second
+#define IK_SUITE_IDLE          12          // CPU idle before the run, in 1/1000
+#define IK_SUITE_FIELDS        13
+#define IK_SUITE_WORDS         (IK_SUITE_FIELDS + 2)
+
+//*****************************************************************************
+//
+// Results and Events
+//
+//*****************************************************************************
+
+#define IK_OK                  0           // Decoded
+#define IK_ERR_CRC             -1          // A CRC or seal did not match
+#define IK_ERR_FORMAT          -2          // Not a frame or page of this format
+#define IK_PAGE_OPEN           1           // A log page still being filled (erased seal)
+#define IK_MORE                2           // The transfer needs more frames
+#define IK_DONE                3           // The transfer is complete
+
+// Callbacks a decoder reports what it found through; any may be 0
+typedef struct {
+    void (*Samples)(void *Ctx, const uint16_t *Samples, size_t Count, bool Lost);
+    void (*Session)(void *Ctx, uint32_t Header);   // A session record (log)
+    void (*Stamp)(void *Ctx, uint64_t Ticks, uint32_t Dropped);  // A stamp record (log)
+    void (*Pressure)(void *Ctx, const float *Kpa, size_t Count, bool Lost);  // Units stream frames
+    void (*Event)(void *Ctx, uint32_t Chan, uint64_t Ticks, uint32_t Duration, uint16_t Peak);  // An event record (log)
+    void (*Alarm)(void *Ctx, uint32_t Chan, uint32_t Causes, uint32_t Tripped, uint16_t Sample,
+                  int16_t Delta);  // A CAN alarm frame (Causes: IK_ALARM_CAUSE_*, 0 = the channel cleared; Tripped: channel mask)
+    void (*Report)(void *Ctx, uint32_t Chan, uint16_t Sample, uint32_t Ms, bool KeepAlive);  // A CAN report-by-exception frame
+    void (*Rate)(void *Ctx, uint32_t Hz);          // A rate record (log): the sample rate from here on
+    void (*Angle)(void *Ctx, uint32_t Position, bool Backwards);  // An angle record (log): encoder position of the next frame
+    void (*Quality)(void *Ctx, uint32_t Flags);    // A quality record (log): IK_QUAL_ flags of the next sample
+    void *Ctx;
+} ik_events_t;
+
+//*****************************************************************************
+//
+// CRCs: the firmware's driverlib sw_crc routines; Crc32 follows the firmware's
+// use (start at 0xFFFFFFFF, invert the result)
+//
+//*****************************************************************************
+
+uint16_t Ik_Crc16(uint16_t Crc, const uint8_t *Data, size_t Len);
+uint32_t Ik_Crc32(uint32_t Crc, const uint8_t *Data, size_t Len);
+
+//*****************************************************************************
+//
+// Halfword Stream: the samples and records of the log, and the payload of a
+// delta compressed stream frame; a decoder keeps its place across calls, so a
+// record or a session may span log pages
+//
+//*****************************************************************************
+
+typedef struct {
+    bool Delta;                    // The halfwords are delta compressed
+    bool Rice;                     // The halfwords are Rice coded (a session record says so)
+    uint16_t Prev;                 // Previous sample, the base of the next delta
+    uint32_t Shift;                // Bits the samples were stored shifted down (8-bit: IK_SAMPLE_8BIT_SHIFT)
+    uint64_t RiceAcc;              // Rice stream bits not yet decoded, newest in the low bits
+    uint32_t RiceBits;             // Bits held in RiceAcc
+    uint32_t RiceK;                // k of the block
+    uint32_t RiceSum;              // Sum of the block's deltas so far
+    uint32_t RiceCount;            // Deltas of the block so far
+    uint16_t Record[IK_EVENT_RECORD_SIZE];  // Record being collected
+    uint32_t RecordLen;            // Halfwords of it collected (0 = none)
+    uint32_t RecordSize;           // Halfwords it has
+    bool Records;                  // Records may appear (log, not stream payloads)
+    uint32_t Sessions;             // Session records decoded
+    uint32_t Events;               // Event records decoded
+    uint32_t Qualities;            // Quality records decoded
+    uint32_t Rate;                 // Sample rate of the last rate record, Hz (0 = none yet)
+    uint64_t Samples;              // Samples decoded
+} ik_half_t;
+
+void Ik_HalfInit(ik_half_t *Dec, bool Delta, bool Records);
+size_t Ik_HalfExpand(ik_half_t *Dec, uint16_t Half, uint16_t *Out);
+void Ik_HalfFeed(ik_half_t *Dec, const uint16_t *Half, size_t Count, const ik_events_t *Ev);
+
+//*****************************************************************************
+//
+// Flash Log: pages as icmdFlashGetData, icmdFlashBulkDump, ISO-TP and the
+// mass-storage BIN files deliver them, oldest first, words little-endian as
+// stored; the page size is 1024 (internal flash) or 4096 (SPI NOR)
+//
+//*****************************************************************************
+
+typedef struct {
+    uint32_t Seq;                  // Page sequence number
+    uint8_t Codec;                 // IK_LOG_CODEC_* of the session written (0 raw), IK_LOG_CODEC_8BIT added
+    uint8_t Channels;              // Channels of the session (0 = none open)
+    uint32_t ChannelMask;          // Bit per ADC input, bit 16 the temperature sensor
+    uint32_t Rate;                 // Sample rate in Hz at the seek point
+    uint64_t Stamp;                // Timestamp of the session start
+    uint32_t SessionBytes;         // Session bytes written before the page
+    uint32_t SeekMs;               // Seek point: ms of the last stamp record before the page (IK_LOG_SEEK_NONE = none)
+    uint32_t SeekAddr;             // Seek point: log address of that stamp record
+} ik_block_t;
+
+typedef struct {
+    ik_half_t Half;                // Halfword decoder of the session being read
+    ik_block_t Block;              // Header of the last page read
+    uint32_t LastSeq;              // Sequence number of the last page read
+    bool HaveSeq;                  // LastSeq is valid
+    uint32_t Pages;                // Pages read
+    uint32_t BadPages;             // Pages with a bad header or seal
+    uint32_t SeqGaps;              // Pages whose sequence number did not follow
+} ik_log_t;
+
+void Ik_LogInit(ik_log_t *Log);
+int Ik_LogPage(ik_log_t *Log, const uint8_t *Page, size_t PageSize, const ik_events_t *Ev);
+int Ik_LogBlock(const uint8_t *Page, ik_block_t *Block);
+
+//*****************************************************************************
+//
+// UART0 / Virtual COM Port Stream: a byte stream cut into frames at their
+// sync bytes; a frame whose CRC16 fails is skipped a byte at a time, so the
+// decoder resyncs on the next frame
+//
+//*****************************************************************************
+
+typedef struct {
+    uint8_t Buf[IK_UART_FRAME_MAX];
+    size_t Len;                    // Bytes in Buf
+    uint32_t NextSeq;              // Sequence count expected next
+    bool HaveSeq;
+    uint64_t Frames;               // Frames decoded
+    uint64_t CrcErrors;            // Candidate frames rejected by their CRC16
+    uint64_t SkippedBytes;         // Bytes dropped while resyncing
+    uint64_t SeqGaps;              // Frames missing by the sequence count
+    uint64_t LostFlags;            // Frames flagged lost by the unit
+    uint64_t QualityFlags;         // Frames flagged IK_UART_QUALITY
+    uint64_t Samples;              // Samples decoded
+} ik_uart_t;
+
+void Ik_UartInit(ik_uart_t *Dec);
+void Ik_UartFeed(ik_uart_t *Dec, const uint8_t *Data, size_t Len, const ik_events_t *Ev);
+
+//*****************************************************************************
+//
+// USB Bulk: one IN packet per call; DATA packets are handed to the Data
+// callback (log bytes as stored) and checked against the END packet's CRC32
+//
+//*****************************************************************************
+
+typedef struct {
+    void (*Reply)(void *Ctx, uint8_t Command, const uint32_t *Words, size_t Count);
+    void (*Data)(void *Ctx, const uint8_t *Bytes, size_t Len);
+    uint32_t RangeCrc;             // Running CRC32 of the ranged read
+    uint8_t NextDataSeq;           // DATA / END sequence count expected next
+    uint8_t NextStreamSeq;         // STREAM sequence count expected next
+    bool HaveStreamSeq;
+    uint64_t Packets;              // Packets decoded
+    uint64_t DataBytes;            // Log bytes received
+    uint64_t RangeErrors;          // Ranged reads whose CRC32 or sequence failed
+    uint64_t SeqGaps;              // STREAM packets missing by the sequence count
+    uint64_t LostFlags;            // STREAM packets flagged lost by the unit
+    uint64_t QualityFlags;         // STREAM packets flagged IK_USB_STREAM_QUALITY
+    uint64_t Samples;              // Stream samples decoded
+} ik_usb_t;
+
+void Ik_UsbInit(ik_usb_t *Dec);
+int Ik_UsbPacket(ik_usb_t *Dec, const uint8_t *Pkt, size_t Len, const ik_events_t *Ev);
+
+//*****************************************************************************
+//
+// CAN: the live stream frames on IK_CAN_STREAM_ID, the bulk dump frames (29-bit
+// IDs, windows and pages checked against their trailers; a failed window's
+// number goes to icmdFlashBulkResend, and the re-sent windows come to
+// BulkWindow only, as do the windows of the acknowledged dump, whose count
+// received in order the caller acknowledges) and ISO-TP transfers on
+// IK_ISOTP_TX_ID, reassembled into a caller buffer; after a first frame the
+// caller sends FlowControl on IK_ISOTP_RX_ID
+//
+//*****************************************************************************
+
+typedef struct {
+    void (*BulkPage)(void *Ctx, uint32_t Addr, const uint8_t *Bytes, size_t Len, bool CrcOk);
+    void (*BulkWindow)(void *Ctx, uint32_t Window, const uint8_t *Bytes, size_t Len, bool CrcOk,
+                       bool Resent);
+    uint8_t *Page;                 // Bulk dump page buffer (the log page size)
+    size_t PageSize;
+    size_t PageLen;                // Bytes collected of the bulk page
+    uint32_t PageCrc;              // Running CRC32 of them
+    size_t WinLen;                 // Bytes collected of the bulk window
+    uint16_t WinCrc;               // Running CRC16 of them
+    uint16_t NextBulkSeq;          // Bulk frame sequence expected next
+    bool HaveBulkSeq;
+    uint8_t *Xfer;                 // ISO-TP transfer buffer
+    size_t XferSize;
+    size_t XferLen;                // Length from the first frame
+    size_t XferGot;                // Bytes received
+    uint8_t XferSN;                // Sequence number expected next
+    uint8_t FlowControl[8];        // Frame to send on IK_ISOTP_RX_ID after a first frame
+    uint8_t NextStreamSeq;
+    bool HaveStreamSeq;
+    uint64_t Frames;               // Frames decoded
+    uint64_t Bytes;                // Payload bytes received (all frame kinds)
+    uint64_t SeqGaps;              // Stream or bulk frames missing by their sequence counts
+    uint64_t LostFlags;            // Stream frames flagged lost by the unit
+    uint64_t Alarms;               // Alarm frames received
+    uint64_t AlarmGaps;            // Alarm frames missing by their sequence count
+    uint8_t NextAlarmSeq;
+    bool HaveAlarmSeq;
+    uint64_t Reports;              // Report-by-exception frames received
+    uint64_t ReportGaps;           // Report frames missing by their sequence count
+    uint8_t NextReportSeq;
+    bool HaveReportSeq;
+    uint64_t BadPages;             // Bulk pages failing their trailer CRC32
+    uint64_t BadWindows;           // Bulk windows failing their trailer CRC16
+    uint64_t XferErrors;           // ISO-TP transfers broken off
+    uint64_t Samples;              // Stream samples decoded
+} ik_can_t;
+
+void Ik_CanInit(ik_can_t *Dec, uint8_t *Page, size_t PageSize, uint8_t *Xfer, size_t XferSize);
+int Ik_CanFrame(ik_can_t *Dec, uint32_t Id, bool Extended, const uint8_t *Data, size_t Dlc,
+                const ik_events_t *Ev);
+
+//*****************************************************************************
+//
+// Benchmark Suite Records: the icmdBenchSuite reply words of two builds
+// parsed and compared field by field; a record of an older build with fewer
+// fields leaves the rest IK_SUITE_NONE. Ik_SuiteDiff gives the change of a
+// field in 1/1000 of the old figure, signed so that a positive change is an
+// improvement whichever way the field runs (IK_ERR_FORMAT when either side
+// did not measure it)
+//
+//*****************************************************************************
+
+typedef struct {
+    uint32_t State;                // IK_SUITE_STATE_*
+    uint32_t Build;                // BuildVersion of the build measured
+    uint32_t Value[IK_SUITE_FIELDS];  // The fields (IK_SUITE_NONE = not measured)
+} ik_suite_t;
+
+int Ik_SuiteParse(ik_suite_t *Rec, const uint32_t *Words, size_t Count);
+const char *Ik_SuiteName(uint32_t Field);
+const char *Ik_SuiteUnit(uint32_t Field);
+bool Ik_SuiteHigherBetter(uint32_t Field);
+int Ik_SuiteDiff(const ik_suite_t *Old, const ik_suite_t *New, uint32_t Field, int32_t *PerMille);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IKDECODE_H
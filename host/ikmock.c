@@ -0,0 +1,86 @@
+//*****************************************************************************
+//
+// ikmock.c - Host stand-ins for driverlib calls (see ikmock.h)
+//
+//*****************************************************************************
+
+#if !defined(__TI_ARM__)
+
+#include <string.h>
+#include "ikmock.h"
+
+ikmock_t IkMock;
+
+//*****************************************************************************
+//
+// IkMock_Init: Restarts the mock with a signal and clears its counts
+//
+// \param AdcSteps - Samples per frame (1 .. IKMOCK_ADC_MAX_STEPS)
+// \param PeriodFrames - Frames per period of the generated signal
+// \param SpikeEvery - Frames between single-sample spikes (0 = none)
+//
+//*****************************************************************************
+
+void IkMock_Init(uint32_t AdcSteps, uint32_t PeriodFrames, uint32_t SpikeEvery)
+{
+    memset(&IkMock, 0, sizeof(IkMock));
+    IkMock.AdcSteps = (AdcSteps == 0) ? 1 : (AdcSteps > IKMOCK_ADC_MAX_STEPS) ? IKMOCK_ADC_MAX_STEPS : AdcSteps;
+    IkMock.AdcStep = (PeriodFrames == 0) ? 0 : 0x10000 / PeriodFrames;
+    IkMock.AdcNoise = 0x12345678;
+    IkMock.AdcSpikeEvery = SpikeEvery;
+}
+
+//*****************************************************************************
+//
+// ADCSequenceDataGet: Returns one frame of the generated signal, a triangle
+// around mid-scale with a little noise (smooth, as pressure is), each channel
+// offset from the previous one, and now and then a spike on the first
+//
+//*****************************************************************************
+
+int32_t ADCSequenceDataGet(uint32_t ui32Base, uint32_t ui32SequenceNum, uint32_t *pui32Buffer)
+{
+    uint32_t Phase, Level, i;
+
+    (void)ui32Base;
+    (void)ui32SequenceNum;
+
+    Phase = IkMock.AdcPhase & 0xFFFF;
+    IkMock.AdcPhase += IkMock.AdcStep;
+    Level = (Phase < 0x8000) ? Phase : 0xFFFF - Phase;        // 0 .. 0x7FFF
+    for (i = 0; i < IkMock.AdcSteps; i++)
+    {
+        IkMock.AdcNoise = IkMock.AdcNoise * 1664525 + 1013904223;
+        pui32Buffer[i] = (1448 + (Level >> 4) + (i << 6) + (IkMock.AdcNoise >> 30)) & 0x0FFF;
+    }
+    IkMock.AdcReads++;
+    if (IkMock.AdcSpikeEvery && (IkMock.AdcReads % IkMock.AdcSpikeEvery) == 0)
+        pui32Buffer[0] = 0x0FFF;
+
+    return (int32_t)IkMock.AdcSteps;
+}
+
+//*****************************************************************************
+//
+// CANMessageSet: Takes the frame a transmit object would be loaded with
+//
+//*****************************************************************************
+
+void CANMessageSet(uint32_t ui32Base, uint32_t ui32ObjID, tCANMsgObject *psMsgObject,
+                   tMsgObjType eMsgType)
+{
+    uint32_t Len = (psMsgObject->ui32MsgLen > 8) ? 8 : psMsgObject->ui32MsgLen;
+    uint32_t i;
+
+    (void)ui32Base;
+    (void)ui32ObjID;
+    (void)eMsgType;
+
+    IkMock.CanFrames++;
+    IkMock.CanLastId = psMsgObject->ui32MsgID;
+    memcpy(IkMock.CanLast, psMsgObject->pui8MsgData, Len);
+    for (i = 0; i < Len; i++)
+        IkMock.CanCheck = IkMock.CanCheck * 31 + IkMock.CanLast[i];
+}
+
+#endif
@@ -0,0 +1,46 @@
+//*****************************************************************************
+//
+// ikmock.h - Host stand-ins for the driverlib calls the firmware core's
+// benchmark paths make: the ADC sequencer FIFO read, fed from a generated
+// pressure signal, and the CAN message object load, which only counts and
+// keeps the frames. The prototypes are driverlib's own (driverlib/adc.h,
+// driverlib/can.h), so the code under test compiles as on the target
+//
+//*****************************************************************************
+
+#ifndef IKMOCK_H
+#define IKMOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driverlib/adc.h"
+#include "driverlib/can.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IKMOCK_ADC_MAX_STEPS 8     // Samples one ADCSequenceDataGet returns at most
+
+typedef struct {
+    uint32_t AdcSteps;             // Samples per ADCSequenceDataGet (the frame's channels)
+    uint32_t AdcPhase;             // Phase of the generated signal, Q16 of a period
+    uint32_t AdcStep;              // Phase advance per frame
+    uint32_t AdcNoise;             // Noise generator state
+    uint32_t AdcSpikeEvery;        // Frames between single-sample spikes (0 = none)
+    uint64_t AdcReads;             // ADCSequenceDataGet calls
+    uint64_t CanFrames;            // CANMessageSet calls
+    uint32_t CanLastId;            // ID of the last frame
+    uint8_t CanLast[8];            // Data of the last frame
+    uint32_t CanCheck;             // Running check of the frame data
+} ikmock_t;
+
+extern ikmock_t IkMock;
+
+void IkMock_Init(uint32_t AdcSteps, uint32_t PeriodFrames, uint32_t SpikeEvery);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IKMOCK_H
@@ -0,0 +1,74 @@
+//*****************************************************************************
+//
+// ikconfig.h - Compile-time configuration of the Inkley_PressureSensor image:
+// the log storage, the transports and CAN protocols, the DSP stages and the
+// instrumentation built in. A switch at 0 compiles its paths out of main.c
+// (the code, its SRAM and its branches in the ISRs and tasks); the commands
+// of a feature left out stay in the table and answer 0xFFFFFFFF, so a host
+// can tell. main.c includes this header ahead of its own settings, so an
+// image is specialized here and nowhere else
+//
+//*****************************************************************************
+
+#ifndef IKCONFIG_H
+#define IKCONFIG_H
+
+//*****************************************************************************
+//
+// Storage
+//
+//*****************************************************************************
+
+#define LOG_STORE_SPI_NOR  0       // 1 = log to an external SPI NOR when one is fitted
+#define USB_MSC_VOLUME     0       // 1 = build in the USB mass-storage log volume (see USB Mass Storage Settings)
+#define SIDE_LOG_ENABLE    1       // 1 = build in the side logs and their flash regions (see Side Log Settings)
+#define SIDE_LOG_PAGES     8       // Internal flash pages (1 KB, 502 side samples) of each side log's region
+
+//*****************************************************************************
+//
+// Transports and CAN protocols
+//
+//*****************************************************************************
+
+#define J1939_ENABLE       1       // 1 = build in the J1939 address claim and BAM sender
+#define PDO_ENABLE         1       // 1 = build in the transmit PDOs
+#define NODE_STRAP_ENABLE  0       // 1 = read the node from the strap pins at boot
+
+//*****************************************************************************
+//
+// Sample format
+//
+//*****************************************************************************
+
+#define SAMPLE_8BIT        0       // 1 = keep the top 8 bits of each result, a byte in SensorBuf (see Sample Storage Format, ikcore.h); no uDMA mode or bursts
+
+//*****************************************************************************
+//
+// DSP stages
+//
+//*****************************************************************************
+
+#define FFT_ENABLE         0       // 1 = build in the background spectrum (see Spectrum Settings)
+
+//*****************************************************************************
+//
+// Instrumentation. The defaults fit the 32 KB of SRAM with a 2048-sample
+// SensorBuf; the spectrum, the profile sections and the full trace ring take
+// 4.7 KB between them, so turning them on trips the SRAM budget check in
+// main.c until SRAM_RESERVED is raised (which halves SensorBuf)
+//
+//*****************************************************************************
+
+#define PROFILE_ENABLE     0       // 1 = time the ISRs, the erase stall and the tasks, 0 = no profiling code
+#define TRACE_ENABLE       0       // 1 = build in the event trace, 0 = no trace code
+#define ITM_ENABLE         0       // 1 = build in the ITM output, 0 = no ITM code
+#define STACK_MON_ENABLE   1       // 1 = paint the stack and report its high-water mark
+#define STACK_GUARD_ENABLE 1       // 1 = an MPU guard region at the bottom of the stack
+#define LAT_BENCH_ENABLE   1       // 1 = build in the latency benchmark, 0 = no benchmark code
+#define XPUT_BENCH_ENABLE  1       // 1 = build in the throughput benchmark, 0 = no benchmark code
+#define JIT_ENABLE         1       // 1 = build in the jitter measurement, 0 = no jitter code
+#define FLOOD_ENABLE       1       // 1 = build in the flood test, 0 = no test code
+#define KBENCH_ENABLE      1       // 1 = build in the kernel benchmark, 0 = no benchmark code
+#define SUITE_ENABLE       1       // 1 = build in the benchmark suite, 0 = no suite code
+
+#endif // IKCONFIG_H
@@ -0,0 +1,788 @@
+//*****************************************************************************
+//
+// ikcore.c - Platform-independent core of the Inkley_PressureSensor firmware
+// (see ikcore.h)
+//
+//*****************************************************************************
+
+#include "ikcore.h"
+
+//*****************************************************************************
+//
+// Circular Buffer
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// circ_bbuf_clear_stats: Resets the push, drop, overwrite and high-water counters
+//
+// \param c - Pointer to the circular buffer structure
+//
+//*****************************************************************************
+
+void circ_bbuf_clear_stats(circ_bbuf_t *c)
+{
+    c->pushes = 0;
+    c->drops = 0;
+    c->overwrites = 0;
+    c->highwater = 0;
+}
+
+//*****************************************************************************
+//
+// Init_circ_bbuf: Initializes the circular buffer structure; this sets the buffer
+// data pointer, the maximum size, and initializes the head and tail pointers
+//
+// \param c - Pointer to the circular buffer structure
+// \param data - The array that holds the buffer elements
+// \param len - The number of elements in the array (must be a power of two)
+//
+//*****************************************************************************
+
+void Init_circ_bbuf(circ_bbuf_t *c, sample_t *data, int len)
+{
+    c->bufdata = data;               // Set the buffer data array
+    c->maxlen = len;                 // Set the buffer capacity
+    c->mask = len - 1;               // Set the wrap mask
+    c->head = 0;                     // Initialize the head pointer to the start
+    c->tail = 0;                     // Initialize the tail pointer to the start
+    circ_bbuf_clear_stats(c);        // Start the accounting from zero
+}
+
+#if SAMPLE_8BIT
+//*****************************************************************************
+//
+// Init_circ_sbuf: Initializes the sample ring of a SAMPLE_8BIT build over its
+// byte array (see ikcore.h)
+//
+//*****************************************************************************
+
+void Init_circ_sbuf(circ_bbuf_t *c, ring_sample_t *data, int len)
+{
+    Init_circ_bbuf(c, 0, len);
+    c->bytedata = data;              // The elements are bytes
+}
+#endif
+
+//*****************************************************************************
+//
+// circ_bbuf_reader_seek / circ_bbuf_reader_release: The cursor steps of a
+// reader pop, shared by the halfword and the byte rings; seek joins or
+// resyncs the reader and takes the slot it reads next, release moves the tail
+// up to the slowest active cursor
+//
+// \param head / used - The head and the used count the pop started from
+//
+// \return circ_bbuf_reader_seek: the slot to read, or -1 if nothing is left
+//
+//*****************************************************************************
+
+static int circ_bbuf_reader_seek(circ_bbuf_t *c, circ_bbuf_reader_t *rd, int head, int used)
+{
+    int behind, at;
+
+    if (!rd->active)
+    {
+        rd->cursor = c->tail;
+        rd->active = 1;
+    }
+
+    // Data behind the tail is gone; count it and resume at the tail
+    behind = (head - rd->cursor) & c->mask;
+    if (behind > used)
+    {
+        rd->lagged += behind - used;
+        rd->cursor = c->tail;
+    }
+
+    if (rd->cursor == head)
+        return -1;
+
+    at = rd->cursor;
+    rd->cursor = (at + 1) & c->mask;
+
+    return at;
+}
+
+static void circ_bbuf_reader_release(circ_bbuf_t *c, circ_bbuf_reader_t *readers, int count, int head, int used)
+{
+    int behind, slowest, i;
+
+    // Release only what every active reader has consumed
+    slowest = 0;
+    for (i = 0; i < count; i++)
+    {
+        if (!readers[i].active)
+            continue;
+        behind = (head - readers[i].cursor) & c->mask;
+        if (behind > used)
+            behind = used;
+        if (behind > slowest)
+            slowest = behind;
+    }
+    c->tail = (head - slowest) & c->mask;
+}
+
+//*****************************************************************************
+//
+// circ_bbuf_reader_pop: Pops data for one consumer of a buffer shared through
+// read cursors; a reader joins at the current tail on its first pop; if the
+// producer overwrote data the reader had not read yet, the reader is marked as
+// lagging and resumes at the oldest data still held; afterwards the buffer's tail
+// moves up to the slowest active cursor, which gates the drop-newest policy;
+// consumer only
+//
+// \param c - Pointer to the circular buffer structure
+// \param readers - The read cursors sharing the buffer
+// \param count - The number of read cursors
+// \param r - The index of the reader popping
+// \param data - Pointer to store the popped data
+//
+// \return 0 if successful, -1 if nothing is left for this reader
+//
+//*****************************************************************************
+
+int circ_bbuf_reader_pop(circ_bbuf_t *c, circ_bbuf_reader_t *readers, int count, int r, sample_t *data)
+{
+    int head = c->head;
+    int used = (head - c->tail) & c->mask;
+    int at = circ_bbuf_reader_seek(c, &readers[r], head, used);
+
+    if (at < 0)
+        return -1;
+
+    *data = c->bufdata[at];
+    circ_bbuf_reader_release(c, readers, count, head, used);
+
+    return 0;  // Return success
+}
+
+#if SAMPLE_8BIT
+int circ_sbuf_reader_pop(circ_bbuf_t *c, circ_bbuf_reader_t *readers, int count, int r, ring_sample_t *data)
+{
+    int head = c->head;
+    int used = (head - c->tail) & c->mask;
+    int at = circ_bbuf_reader_seek(c, &readers[r], head, used);
+
+    if (at < 0)
+        return -1;
+
+    *data = c->bytedata[at];
+    circ_bbuf_reader_release(c, readers, count, head, used);
+
+    return 0;  // Return success
+}
+#endif
+
+//*****************************************************************************
+//
+// circ_bbuf_readers_reset: Detaches every read cursor, for example after the
+// buffer itself has been rewound; each reader rejoins on its next pop
+//
+// \param readers - The read cursors sharing the buffer
+// \param count - The number of read cursors
+//
+//*****************************************************************************
+
+void circ_bbuf_readers_reset(circ_bbuf_reader_t *readers, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        readers[i].active = 0;
+        readers[i].lagged = 0;
+    }
+}
+
+//*****************************************************************************
+//
+// circ_bbuf_advance_head: Commits a block of data that was written directly into
+// the buffer array (for example by uDMA) by moving the head forward; if the block
+// overwrote unread data, the tail is moved to the start of the block so that only
+// the freshly written samples remain readable (the one case where the producer
+// moves the tail, since the overwritten samples are already gone)
+//
+// \param c - Pointer to the circular buffer structure
+// \param count - The number of samples written starting at the current head
+//
+// \return 0 if successful, -1 if unread data was overwritten
+//
+//*****************************************************************************
+
+int circ_bbuf_advance_head(circ_bbuf_t *c, int count)
+{
+    int start = c->head;
+    int used = circ_bbuf_used(c);
+
+    c->pushes += count;
+
+    // If the block did not fit in the free space, drop the overwritten samples
+    if (count > c->mask - used)
+    {
+        c->overwrites += used;
+        c->tail = start;
+        c->head = (start + count) & c->mask;
+        if (count > c->highwater)
+            c->highwater = count;
+        return -1;
+    }
+
+    // Move the head past the block, wrapping at the end of the buffer
+    c->head = (start + count) & c->mask;
+    if (used + count > c->highwater)
+        c->highwater = used + count;
+
+    return 0;  // Return success
+}
+
+//*****************************************************************************
+//
+// Delta Encoder
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Delta_Reset: Restarts an encoder so that its next sample is a keyframe
+//
+// \param Enc - The encoder
+//
+//*****************************************************************************
+
+void Delta_Reset(delta_enc_t *Enc)
+{
+    Enc->Count = 0;
+    Enc->Keyed = false;
+}
+
+//*****************************************************************************
+//
+// Delta_Drain: Packs pending deltas into halfwords; 3-bit deltas are held back
+// until four fill a halfword and 6-bit ones until two do, unless All is set
+//
+// \param Enc - The encoder
+// \param Out - Receives the packed halfwords
+// \param All - Pack every pending delta, filling partial halfwords
+//
+// \return The number of halfwords written to Out
+//
+//*****************************************************************************
+
+int Delta_Drain(delta_enc_t *Enc, sample_t *Out, bool All)
+{
+    int Emitted = 0;
+    int i, Take, Max;
+
+    while (Enc->Count > 0)
+    {
+        Max = 0;
+        for (i = 0; i < Enc->Count; i++)
+            if (Enc->Pend[i] > Max) Max = Enc->Pend[i];
+
+        if (Max <= DELTA_QUAD_MAX)
+        {
+            if (Enc->Count < 4 && !All)
+                break;
+
+            Out[Emitted] = DELTA_TAG_QUAD | ((Enc->Count - 1) << 12);
+            for (i = 0; i < Enc->Count; i++)
+                Out[Emitted] |= Enc->Pend[i] << (i * 3);
+            Take = Enc->Count;
+        }
+        else
+        {
+            if (Enc->Count < 2 && !All)
+                break;
+
+            Take = (Enc->Count < 2) ? 1 : 2;
+            Out[Emitted] = DELTA_TAG_PAIR | ((Take - 1) << 12) | Enc->Pend[0];
+            if (Take > 1)
+                Out[Emitted] |= Enc->Pend[1] << 6;
+        }
+        Emitted++;
+
+        Enc->Count -= Take;
+        for (i = 0; i < Enc->Count; i++)
+            Enc->Pend[i] = Enc->Pend[i + Take];
+    }
+
+    return Emitted;
+}
+
+//*****************************************************************************
+//
+// Delta_Encode: Feeds one sample to an encoder
+//
+// \param Enc - The encoder
+// \param Sample - The sample to encode
+// \param Out - Receives up to DELTA_MAX_OUT halfwords ready to store
+//
+// \return The number of halfwords written to Out
+//
+//*****************************************************************************
+
+int Delta_Encode(delta_enc_t *Enc, sample_t Sample, sample_t *Out)
+{
+    int32_t Delta = (int32_t)Sample - (int32_t)Enc->Prev;
+    uint32_t Zig = ((uint32_t)Delta << 1) ^ (uint32_t)(Delta >> 31);
+    int Emitted;
+
+    Enc->Prev = Sample;
+
+    // Keyframe: everything pending goes out first to keep the order
+    if (!Enc->Keyed || Zig > DELTA_PAIR_MAX)
+    {
+        Emitted = Delta_Drain(Enc, Out, true);
+        Out[Emitted++] = Sample;
+        Enc->Keyed = true;
+        return Emitted;
+    }
+
+    Enc->Pend[Enc->Count++] = (uint8_t)Zig;
+    return Delta_Drain(Enc, Out, false);
+}
+
+//*****************************************************************************
+//
+// Rice Coder
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Rice_Adapt: Counts a delta into its block and, once the block is full,
+// sets the k of the next one from the block's mean
+//
+//*****************************************************************************
+
+static inline void Rice_Adapt(rice_t *Rice, uint32_t Zig)
+{
+    uint32_t Mean;
+
+    Rice->Sum += Zig;
+    if (++Rice->Count < RICE_BLOCK)
+        return;
+
+    Mean = Rice->Sum / RICE_BLOCK;
+    Rice->K = (Mean == 0) ? 0 : (31 - RICE_CLZ(Mean) > RICE_K_MAX) ? RICE_K_MAX : 31 - RICE_CLZ(Mean);
+    Rice->Sum = 0;
+    Rice->Count = 0;
+}
+
+//*****************************************************************************
+//
+// Rice_Bits: Appends up to RICE_RAW_BITS bits to the stream a word at a time
+// and emits a halfword once RICE_BITS are held (fewer than 14 are held
+// before, so the accumulator never overflows)
+//
+//*****************************************************************************
+
+static inline int Rice_Bits(rice_t *Rice, uint32_t Value, uint32_t Count, sample_t *Out)
+{
+    Rice->Acc = (Rice->Acc << Count) | Value;
+    Rice->Bits += Count;
+    if (Rice->Bits < RICE_BITS)
+        return 0;
+
+    Rice->Bits -= RICE_BITS;
+    *Out = RICE_TAG | ((Rice->Acc >> Rice->Bits) & ((1u << RICE_BITS) - 1));
+    return 1;
+}
+
+//*****************************************************************************
+//
+// Rice_Reset: Restarts an encoder so that its next sample is a keyframe; bits
+// not drained are dropped
+//
+// \param Rice - The encoder
+//
+//*****************************************************************************
+
+void Rice_Reset(rice_t *Rice)
+{
+    Rice->Bits = 0;
+    Rice->Keyed = false;
+}
+
+//*****************************************************************************
+//
+// Rice_Drain: Pads the bits an encoder holds with ones to a whole halfword
+//
+// \param Rice - The encoder
+// \param Out - Receives the halfword
+//
+// \return The number of halfwords written to Out (0 or 1)
+//
+//*****************************************************************************
+
+int Rice_Drain(rice_t *Rice, sample_t *Out)
+{
+    uint32_t Pad = RICE_BITS - Rice->Bits;
+
+    if (Rice->Bits == 0)
+        return 0;
+    return Rice_Bits(Rice, (1u << Pad) - 1, Pad, Out);
+}
+
+//*****************************************************************************
+//
+// Rice_Encode: Feeds one sample to an encoder
+//
+// \param Rice - The encoder
+// \param Sample - The sample to encode
+// \param Out - Receives up to RICE_MAX_OUT halfwords ready to store
+//
+// \return The number of halfwords written to Out
+//
+//*****************************************************************************
+
+int Rice_Encode(rice_t *Rice, sample_t Sample, sample_t *Out)
+{
+    int32_t Delta = (int32_t)Sample - (int32_t)Rice->Prev;
+    uint32_t Zig = ((uint32_t)Delta << 1) ^ (uint32_t)(Delta >> 31);
+    uint32_t Quot = Zig >> Rice->K;
+    int Emitted;
+
+    if (!Rice->Keyed)
+    {
+        Out[0] = Sample;
+        Rice_Key(Rice, Sample);
+        Rice->Keyed = true;
+        return 1;
+    }
+    Rice->Prev = Sample;
+
+    if (Quot < RICE_ESC)
+    {
+        Emitted = Rice_Bits(Rice, (2u << Quot) - 2, Quot + 1, Out);
+        Emitted += Rice_Bits(Rice, Zig & ((1u << Rice->K) - 1), Rice->K, Out + Emitted);
+    }
+    else
+    {
+        Emitted = Rice_Bits(Rice, (1u << RICE_ESC) - 1, RICE_ESC, Out);
+        Emitted += Rice_Bits(Rice, Zig, RICE_RAW_BITS, Out + Emitted);
+    }
+    Rice_Adapt(Rice, Zig);
+
+    return Emitted;
+}
+
+//*****************************************************************************
+//
+// Rice_Key / Rice_Put / Rice_Get: Decode a Rice coded halfword stream: a
+// keyframe restarts the decoder (the rest of the stream before it is
+// padding), a stream halfword is appended, and a sample is taken once its
+// code is complete; a code still incomplete never holds more than 18 bits,
+// so the appended halfword always fits the accumulator
+//
+// \param Rice - The decoder
+// \param Sample - The keyframe sample, or receives the next sample
+// \param Half - The stream halfword (RICE_TAG set)
+//
+// \return Rice_Get: false if the stream holds no complete code
+//
+//*****************************************************************************
+
+void Rice_Key(rice_t *Rice, sample_t Sample)
+{
+    Rice->Prev = Sample;
+    Rice->Bits = 0;
+    Rice->Sum = 0;
+    Rice->Count = 0;
+    Rice->K = RICE_K_START;
+    Rice->Escaped = false;
+}
+
+void Rice_Put(rice_t *Rice, sample_t Half)
+{
+    Rice->Acc = (Rice->Acc << RICE_BITS) | (Half & ((1u << RICE_BITS) - 1));
+    Rice->Bits += RICE_BITS;
+}
+
+bool Rice_Get(rice_t *Rice, sample_t *Sample)
+{
+    uint32_t Ones, Zig;
+
+    for (;;)
+    {
+        if (Rice->Escaped)
+        {
+            if (Rice->Bits < RICE_RAW_BITS)
+                return false;
+            Rice->Bits -= RICE_RAW_BITS;
+            Zig = (Rice->Acc >> Rice->Bits) & ((1u << RICE_RAW_BITS) - 1);
+            Rice->Escaped = false;
+            break;
+        }
+        if (Rice->Bits == 0)
+            return false;
+
+        // The quotient is the run of ones at the top of the bits held
+        Ones = RICE_CLZ(~(Rice->Acc << (32 - Rice->Bits)));
+        if (Ones >= RICE_ESC)
+        {
+            Rice->Bits -= RICE_ESC;
+            Rice->Escaped = true;
+            continue;
+        }
+        if (Ones >= Rice->Bits || Rice->Bits < Ones + 1 + Rice->K)
+            return false;
+        Rice->Bits -= Ones + 1 + Rice->K;
+        Zig = (Ones << Rice->K) | ((Rice->Acc >> Rice->Bits) & ((1u << Rice->K) - 1));
+        break;
+    }
+
+    Rice->Prev = (sample_t)(Rice->Prev + ((Zig >> 1) ^ -(Zig & 1)));
+    Rice_Adapt(Rice, Zig);
+    *Sample = Rice->Prev & SAMPLE_MASK;
+    return true;
+}
+
+//*****************************************************************************
+//
+// Biquad Kernel
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Biquad_Pack: Packs a section's coefficients into its SMLAD operands; called
+// after any coefficient changes
+//
+// \param Bq - The section
+//
+//*****************************************************************************
+
+void Biquad_Pack(biquad_t *Bq)
+{
+    Bq->B01 = DSP_PACK(Bq->Coef[0], Bq->Coef[1]);
+    Bq->B2A1 = DSP_PACK(Bq->Coef[2], -Bq->Coef[3]);
+    Bq->A2 = DSP_PACK(-Bq->Coef[4], 0);
+}
+
+//*****************************************************************************
+//
+// Biquad_Cascade: Runs one sample through a cascade of sections
+//
+// \param Bq - The sections
+// \param St - The state of each section for this channel
+// \param Sections - The number of sections to run
+// \param X - The input sample in Q15
+// \param Prime - Fill the state from this sample first (no start-up step)
+//
+// \return The output sample in Q15
+//
+//*****************************************************************************
+
+int32_t Biquad_Cascade(const biquad_t *Bq, biquad_state_t *St, uint32_t Sections, int32_t X, bool Prime)
+{
+    int32_t Acc;
+    uint32_t j;
+
+    for (j = 0; j < Sections; j++, Bq++, St++)
+    {
+        if (Prime)
+            St->X1 = St->X2 = St->Y1 = St->Y2 = (int16_t)X;
+
+        Acc = DSP_SMLAD(DSP_PACK(X, St->X1), Bq->B01, 1 << (FILTER_COEF_SHIFT - 1));
+        Acc = DSP_SMLAD(DSP_PACK(St->X2, St->Y1), Bq->B2A1, Acc);
+        Acc = DSP_SMLAD(DSP_PACK(St->Y2, 0), Bq->A2, Acc);
+        St->X2 = St->X1;
+        St->X1 = (int16_t)X;
+        X = DSP_SSAT16(Acc >> FILTER_COEF_SHIFT);
+        St->Y2 = St->Y1;
+        St->Y1 = (int16_t)X;
+    }
+    return X;
+}
+
+//*****************************************************************************
+//
+// Median Kernel
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Median_Step: Pushes a sample through a channel's window
+//
+// \param Med - The channel's window (Width 3, 5 or 7)
+// \param Sample - The new sample (12-bit)
+//
+// \return the median of the window
+//
+//*****************************************************************************
+
+sample_t Median_Step(median_t *Med, sample_t Sample)
+{
+    uint32_t Width = Med->Width;
+    uint16_t Old;
+    uint32_t i;
+
+    if (!Med->Primed)
+    {
+        for (i = 0; i < Width; i++)
+            Med->Hist[i] = Med->Sorted[i] = Sample;
+        Med->Pos = 0;
+        Med->Primed = true;
+        return Sample;
+    }
+
+    Old = Med->Hist[Med->Pos];
+    Med->Hist[Med->Pos] = Sample;
+    if (++Med->Pos >= Width)
+        Med->Pos = 0;
+
+    // Find the oldest sample, then shift its neighbours over it until the new
+    // one fits
+    for (i = 0; Med->Sorted[i] != Old; i++);
+    if (Sample > Old)
+    {
+        for (; i + 1 < Width && Med->Sorted[i + 1] < Sample; i++)
+            Med->Sorted[i] = Med->Sorted[i + 1];
+    }
+    else
+    {
+        for (; i > 0 && Med->Sorted[i - 1] > Sample; i--)
+            Med->Sorted[i] = Med->Sorted[i - 1];
+    }
+    Med->Sorted[i] = Sample;
+    return Med->Sorted[Width >> 1];
+}
+
+//*****************************************************************************
+//
+// Command Table
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Cmd_Find: Looks a command up in a handler table
+//
+// \param Table - The entries in command byte order, without gaps
+// \param Count - The number of entries
+// \param Command - The command byte
+//
+// \return The entry, or 0 if the command is unknown or has no handler
+//
+//*****************************************************************************
+
+const cmd_entry_t *Cmd_Find(const cmd_entry_t *Table, uint32_t Count, uint32_t Command)
+{
+    uint32_t Index = Command - Table[0].Command;
+
+    if (Command < Table[0].Command || Index >= Count || Table[Index].Handler == 0)
+        return 0;
+    return &Table[Index];
+}
+
+//*****************************************************************************
+//
+// Cmd_Allowed: Checks that a command may run over a transport; CAN-only
+// commands need a CAN request, streaming commands anything but I2C
+//
+// \param Entry - The command
+// \param Source - CMD_SRC_* of the request
+//
+// \return false if the command has to be refused with 0xFFFFFFFF
+//
+//*****************************************************************************
+
+bool Cmd_Allowed(const cmd_entry_t *Entry, uint32_t Source)
+{
+    if ((Entry->Flags & CMD_F_CAN) && Source != CMD_SRC_CAN)
+        return false;
+    if ((Entry->Flags & CMD_F_BULK) && Source == CMD_SRC_I2C)
+        return false;
+    return true;
+}
+
+//*****************************************************************************
+//
+// Cmd_PutWord: Stores a 32-bit reply word most significant byte first
+//
+// \param Buf - The four bytes to fill
+// \param Value - The word
+//
+//*****************************************************************************
+
+void Cmd_PutWord(uint8_t *Buf, uint32_t Value)
+{
+    Put_Be32(Buf, Value);
+}
+
+//*****************************************************************************
+//
+// FE_Init: Binds an instance to a front-end driver and sets the hardware up;
+// the conversions start with FE_Start
+//
+// \param Inst - The instance
+// \param Driver - The backend's operations
+// \param Channels - Samples per frame
+// \param pfnCallback - Called as each frame is reported (interrupt context)
+// \param pvCallbackData - Passed to the callback
+//
+//*****************************************************************************
+
+void FE_Init(fe_instance_t *Inst, const fe_driver_t *Driver, uint32_t Channels,
+             fe_callback_t pfnCallback, void *pvCallbackData)
+{
+    Inst->Driver = Driver;
+    Inst->pfnCallback = pfnCallback;
+    Inst->pvCallbackData = pvCallbackData;
+    Driver->Init(Channels);
+}
+
+//*****************************************************************************
+//
+// FE_Start: Starts or stops the conversions of an instance's front end
+//
+// \param Inst - The instance
+// \param On - true to start, false to stop
+//
+//*****************************************************************************
+
+void FE_Start(fe_instance_t *Inst, bool On)
+{
+    if (Inst->Driver)
+        Inst->Driver->Start(On);
+}
+
+//*****************************************************************************
+//
+// FE_DataReady: Called by a backend's interrupt as a frame is in or was
+// missed; counts it and calls the instance's callback
+//
+// \param Inst - The instance
+// \param ui8Status - FE_STATUS_*
+//
+//*****************************************************************************
+
+void FE_DataReady(fe_instance_t *Inst, uint_fast8_t ui8Status)
+{
+    if (ui8Status == FE_STATUS_OK)
+        Inst->Frames++;
+    else
+        Inst->Errors++;
+    if (Inst->pfnCallback)
+        Inst->pfnCallback(Inst->pvCallbackData, ui8Status);
+}
+
+//*****************************************************************************
+//
+// FE_DataGet: Takes the frame a callback was told about
+//
+// \param Inst - The instance
+// \param Frame - Room for a frame of samples, in channel order
+//
+// \return The samples in the frame
+//
+//*****************************************************************************
+
+uint32_t FE_DataGet(fe_instance_t *Inst, uint32_t *Frame)
+{
+    return Inst->Driver->Fetch(Frame);
+}
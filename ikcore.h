@@ -0,0 +1,619 @@
+//*****************************************************************************
+//
+// ikcore.h - Platform-independent core of the Inkley_PressureSensor firmware:
+// the sample format, the circular buffers, the delta encoder, the biquad and
+// median kernels and the command table lookup. Nothing here touches a
+// peripheral, so main.c and the host benchmark (host/ikcorebench.c) build the
+// same code
+//
+//*****************************************************************************
+
+#ifndef IKCORE_H
+#define IKCORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ikconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//*****************************************************************************
+//
+// Sample Storage Format: ADC results are 12-bit, so samples are kept as packed
+// 16-bit values in the ring buffers and in flash, halving the footprint of the
+// previous 32-bit words; the four spare bits stay clear for samples, which lets
+// in-band records use bit 15 as their marker
+//
+// The halfword is the unit of every format, not a setting: uDMA moves the
+// ADC results into the rings as halfwords, the log pages, the delta and Rice
+// streams (RICE_TAG in bit 14) and the in-band records are halfword formats,
+// the live stream frames carry halfwords, and host/ikdecode.h mirrors all of
+// it; SampleFormatCheck stops a build that changes sample_t or SAMPLE_MASK
+// without them. Denser logs come from the codecs (LOG_CODEC_DELTA, _RICE)
+// and longer RAM captures from decimation, both chosen at run time
+//
+// A build with SAMPLE_8BIT (ikconfig.h) keeps only the top 8 bits of each
+// result where a sample is stored rather than processed: SensorBuf holds a
+// byte a sample (ring_sample_t), so the same SRAM holds twice the history;
+// the log keeps the 8-bit values in the same halfword formats, marked in the
+// session and block headers, so the delta and Rice codecs pack them tighter;
+// raw live stream frames carry two samples a halfword. SAMPLE_NARROW takes a
+// 12-bit sample to its stored form and SAMPLE_WIDEN back, the low bits clear,
+// so everything downstream of the ring still sees 12-bit samples. uDMA
+// cannot narrow the halfwords the ADC FIFO delivers, so the uDMA
+// acquisition mode and the bursts built on it are left out of such a build
+//
+//*****************************************************************************
+
+typedef uint16_t sample_t;         // Stored sample element
+#define SAMPLE_MASK 0x0FFF         // Bits of a stored ADC result
+#define SAMPLE_8BIT_SHIFT 4        // Low bits a SAMPLE_8BIT build drops
+
+#if SAMPLE_8BIT
+typedef uint8_t ring_sample_t;     // SensorBuf element: the top 8 bits of a sample
+#define SAMPLE_SHIFT SAMPLE_8BIT_SHIFT
+#else
+typedef sample_t ring_sample_t;    // SensorBuf element: the sample itself
+#define SAMPLE_SHIFT 0
+#endif
+
+#define SAMPLE_NARROW(x) ((ring_sample_t)((x) >> SAMPLE_SHIFT))  // Sample to its stored form
+#define SAMPLE_WIDEN(x)  ((sample_t)((sample_t)(x) << SAMPLE_SHIFT))  // Stored form to a sample
+
+typedef char SampleFormatCheck[(sizeof(sample_t) == 2 && SAMPLE_MASK < 0x4000 &&
+                                (SAMPLE_MASK >> SAMPLE_SHIFT) <= (ring_sample_t)~0u) ? 1 : -1];
+
+//*****************************************************************************
+//
+// Circular Buffer Implementation: Provides functions for initializing, pushing,
+// and popping data in a circular buffer; this buffer is used to temporarily store
+// sensor data in RAM before writing to flash memory
+//
+// Each buffer is a lock-free single-producer/single-consumer ring: only the
+// producer (an ISR) writes head and only the consumer (the main loop) writes
+// tail, so no interrupt masking is needed; the indices are volatile so the main
+// loop always re-reads them, and the capacity is a power of two so wrapping is a
+// mask instead of a compare; one slot is kept empty to tell full from empty
+//
+//*****************************************************************************
+
+// Structure for a circular buffer
+typedef struct {
+    volatile sample_t *bufdata; // Pointer to buffer data (array)
+#if SAMPLE_8BIT
+    volatile uint8_t *bytedata; // Pointer to the byte array of a sample ring (Init_circ_sbuf)
+#endif
+    volatile int head;          // Head index (where new data is written, producer only)
+    volatile int tail;          // Tail index (where data is read from, consumer only)
+    int maxlen;                 // Maximum length of the buffer (capacity, a power of two)
+    int mask;                   // maxlen - 1, wraps an index into the buffer
+    uint32_t pushes;            // Elements offered to the buffer
+    uint32_t drops;             // Elements refused because the buffer was full
+    uint32_t overwrites;        // Unread elements discarded to make room for new ones
+    int highwater;              // Most elements ever waiting at once
+} circ_bbuf_t;
+
+// Read cursor of one consumer of a shared circular buffer; the buffer's own tail
+// follows the slowest active cursor, so one copy of the data serves every reader
+typedef struct {
+    int cursor;                 // Next index this consumer reads
+    int active;                 // Cursor takes part in gating the buffer
+    uint32_t lagged;            // Elements this consumer lost to overwrites
+} circ_bbuf_reader_t;
+
+void circ_bbuf_clear_stats(circ_bbuf_t *c);
+void Init_circ_bbuf(circ_bbuf_t *c, sample_t *data, int len);
+int circ_bbuf_reader_pop(circ_bbuf_t *c, circ_bbuf_reader_t *readers, int count, int r, sample_t *data);
+void circ_bbuf_readers_reset(circ_bbuf_reader_t *readers, int count);
+int circ_bbuf_advance_head(circ_bbuf_t *c, int count);
+
+//*****************************************************************************
+//
+// circ_bbuf_reserve / circ_bbuf_publish / circ_bbuf_make_room: The steps of a
+// push shared by the halfword and the byte rings; reserve counts the push and
+// returns the slot to store into (-1, counted as a drop, when the buffer is
+// full), publish moves the head past the stored slot, and make_room discards
+// the oldest unread element of a full buffer; producer only
+//
+// \param c - Pointer to the circular buffer structure
+// \param head - The slot circ_bbuf_reserve returned
+//
+// \return circ_bbuf_reserve: the slot, or -1 if the buffer is full;
+// circ_bbuf_make_room: 1 if an element was discarded, else 0
+//
+//*****************************************************************************
+
+static inline int circ_bbuf_reserve(circ_bbuf_t *c)
+{
+    int head = c->head;
+
+    c->pushes++;
+
+    // If the next position is the tail, the buffer is full (cannot push data)
+    if (((head + 1) & c->mask) == c->tail)
+    {
+        c->drops++;
+        return -1;
+    }
+
+    return head;
+}
+
+static inline void circ_bbuf_publish(circ_bbuf_t *c, int head)
+{
+    int next = (head + 1) & c->mask;
+    int used;
+
+    c->head = next;
+
+    used = (next - c->tail) & c->mask;
+    if (used > c->highwater)
+        c->highwater = used;
+}
+
+static inline int circ_bbuf_make_room(circ_bbuf_t *c)
+{
+    if (((c->head + 1) & c->mask) != c->tail)
+        return 0;
+
+    c->tail = (c->tail + 1) & c->mask;
+    c->overwrites++;
+
+    return 1;
+}
+
+//*****************************************************************************
+//
+// circ_bbuf_push: Pushes new data into the circular buffer; if the buffer is full,
+// the function returns an error (-1); otherwise, it updates the head pointer;
+// called by the producer only
+//
+// \param c - Pointer to the circular buffer structure
+// \param data - The data to be pushed into the buffer
+//
+// \return 0 if successful, -1 if the buffer is full
+//
+//*****************************************************************************
+
+static inline int circ_bbuf_push(circ_bbuf_t *c, sample_t data)
+{
+    int head = circ_bbuf_reserve(c);
+
+    if (head < 0)
+        return -1;
+
+    // Store the data before publishing it by moving the head (both accesses are
+    // volatile, so the compiler keeps them in this order)
+    c->bufdata[head] = data;
+    circ_bbuf_publish(c, head);
+
+    return 0;  // Return success
+}
+
+//*****************************************************************************
+//
+// circ_bbuf_push_overwrite: Pushes new data into the circular buffer; if the
+// buffer is full the oldest unread element is discarded first, so the push always
+// succeeds; this moves the tail from the producer, so the consumer must pop with
+// the producer's interrupt masked while this policy is in use
+//
+// \param c - Pointer to the circular buffer structure
+// \param data - The data to be pushed into the buffer
+//
+// \return 0 if the push fitted, 1 if the oldest element was overwritten
+//
+//*****************************************************************************
+
+static inline int circ_bbuf_push_overwrite(circ_bbuf_t *c, sample_t data)
+{
+    int over = circ_bbuf_make_room(c);
+
+    circ_bbuf_push(c, data);
+
+    return over;
+}
+
+//*****************************************************************************
+//
+// circ_bbuf_pop: Pops data from the circular buffer; if the buffer is empty (head
+// equals tail), the function returns an error (-1); otherwise, it updates the tail
+// pointer; called by the consumer only
+//
+// \param c - Pointer to the circular buffer structure
+// \param data - Pointer to store the popped data
+//
+// \return 0 if successful, -1 if the buffer is empty
+//
+//*****************************************************************************
+
+static inline int circ_bbuf_pop(circ_bbuf_t *c, sample_t *data)
+{
+    int tail = c->tail;
+
+    // If head equals tail, the buffer is empty (no data to pop)
+    if (c->head == tail)
+        return -1;
+
+    // Read the data before releasing the slot by moving the tail
+    *data = c->bufdata[tail];
+    c->tail = (tail + 1) & c->mask;
+
+    return 0;  // Return success
+}
+
+//*****************************************************************************
+//
+// circ_bbuf_used / circ_bbuf_free: Return the number of elements waiting to be
+// popped and the number that can still be pushed
+//
+// \param c - Pointer to the circular buffer structure
+//
+// \return The number of used or free elements
+//
+//*****************************************************************************
+
+static inline int circ_bbuf_used(circ_bbuf_t *c)
+{
+    return (c->head - c->tail) & c->mask;
+}
+
+static inline int circ_bbuf_free(circ_bbuf_t *c)
+{
+    return c->mask - circ_bbuf_used(c);
+}
+
+//*****************************************************************************
+//
+// circ_bbuf_read_span / circ_bbuf_advance_tail: Zero-copy bulk read; the span is
+// the readable region that is contiguous in the array (it stops at the wrap), and
+// is released once processed by advancing the tail; consumer only
+//
+// \param c - Pointer to the circular buffer structure
+// \param data - Set to the first readable element
+// \param count - The number of elements to release
+//
+// \return The number of elements in the span
+//
+//*****************************************************************************
+
+static inline int circ_bbuf_read_span(circ_bbuf_t *c, sample_t **data)
+{
+    int head = c->head;
+    int tail = c->tail;
+
+    // The elements below head were published before head was read, so the span
+    // can be handed out as plain memory
+    *data = (sample_t *)&c->bufdata[tail];
+
+    return (head >= tail) ? head - tail : c->maxlen - tail;
+}
+
+static inline void circ_bbuf_advance_tail(circ_bbuf_t *c, int count)
+{
+    c->tail = (c->tail + count) & c->mask;
+}
+
+//*****************************************************************************
+//
+// circ_bbuf_write_span: Zero-copy bulk write; returns the free region that is
+// contiguous in the array, which the producer fills in place and then commits
+// with circ_bbuf_advance_head; producer only
+//
+// \param c - Pointer to the circular buffer structure
+// \param data - Set to the first writable element
+//
+// \return The number of elements that can be written without overwriting data
+//
+//*****************************************************************************
+
+static inline int circ_bbuf_write_span(circ_bbuf_t *c, sample_t **data)
+{
+    int head = c->head;
+    int free = circ_bbuf_free(c);
+
+    *data = (sample_t *)&c->bufdata[head];
+
+    return (free < c->maxlen - head) ? free : c->maxlen - head;
+}
+
+//*****************************************************************************
+//
+// Init_circ_sbuf / circ_sbuf_push / circ_sbuf_push_overwrite /
+// circ_sbuf_reader_pop: The sample ring (SensorBuf), whose elements are
+// ring_sample_t; in a SAMPLE_8BIT build they work on the byte array with the
+// indices, statistics and reader cursors of circ_bbuf_t, so circ_bbuf_used,
+// the stamps and the statistics serve both, and otherwise they are the
+// halfword functions themselves; the uDMA and span functions stay halfword
+// only
+//
+//*****************************************************************************
+
+#if SAMPLE_8BIT
+void Init_circ_sbuf(circ_bbuf_t *c, ring_sample_t *data, int len);
+int circ_sbuf_reader_pop(circ_bbuf_t *c, circ_bbuf_reader_t *readers, int count, int r, ring_sample_t *data);
+
+static inline int circ_sbuf_push(circ_bbuf_t *c, ring_sample_t data)
+{
+    int head = circ_bbuf_reserve(c);
+
+    if (head < 0)
+        return -1;
+
+    c->bytedata[head] = data;
+    circ_bbuf_publish(c, head);
+
+    return 0;  // Return success
+}
+
+static inline int circ_sbuf_push_overwrite(circ_bbuf_t *c, ring_sample_t data)
+{
+    int over = circ_bbuf_make_room(c);
+
+    circ_sbuf_push(c, data);
+
+    return over;
+}
+#else
+#define Init_circ_sbuf           Init_circ_bbuf
+#define circ_sbuf_push           circ_bbuf_push
+#define circ_sbuf_push_overwrite circ_bbuf_push_overwrite
+#define circ_sbuf_reader_pop     circ_bbuf_reader_pop
+#endif
+
+//*****************************************************************************
+//
+// Sample Compression: Logged samples are smooth, so a compressed session stores
+// the difference to the previous sample, zigzag folded (0, -1, 1, -2... become
+// 0, 1, 2, 3...), bit-packed into the same halfword stream as the records; the
+// top bits of each halfword select its meaning, so record markers (bit 15 set)
+// stay unambiguous:
+//   0000 kkkk kkkk kkkk - keyframe: a raw 12-bit sample
+//   001c bbbb bbaa aaaa - c+1 deltas of 6 bits (-32..31), first in the low bits
+//   01cc dddc ccbb baaa - cc+1 deltas of 3 bits (-4..3), first in the low bits
+// A keyframe starts every stamp block (and so follows every gap), and any delta
+// that does not fit 6 bits is stored as a keyframe instead
+//
+//*****************************************************************************
+
+#define DELTA_TAG_PAIR  0x2000     // Halfword of one or two 6-bit deltas
+#define DELTA_TAG_QUAD  0x4000     // Halfword of one to four 3-bit deltas
+#define DELTA_PAIR_MAX  0x3F       // Largest zigzag delta of a pair halfword
+#define DELTA_QUAD_MAX  0x07       // Largest zigzag delta of a quad halfword
+#define DELTA_MAX_OUT   3          // Most halfwords one Delta_Encode call emits
+
+typedef struct {
+    sample_t Prev;                 // Previous sample, the base of the next delta
+    uint8_t Pend[4];               // Zigzag deltas not yet packed into a halfword
+    int Count;                     // Number of pending deltas
+    bool Keyed;                    // A keyframe has been emitted since the last reset
+} delta_enc_t;
+
+void Delta_Reset(delta_enc_t *Enc);
+int Delta_Drain(delta_enc_t *Enc, sample_t *Out, bool All);
+int Delta_Encode(delta_enc_t *Enc, sample_t Sample, sample_t *Out);
+
+//*****************************************************************************
+//
+// Rice Coding: The residuals of smooth pressure are close to Laplacian, so a
+// Rice coded session packs the same zigzag deltas tighter than the fixed
+// fields above: a delta z is z >> k ones, a zero, then the k low bits of z,
+// most significant bit first; a quotient of RICE_ESC or more is RICE_ESC ones
+// and the 13-bit z instead. k adapts per block: after every RICE_BLOCK deltas
+// it becomes log2 of their mean (by CLZ), so encoder and decoder follow each
+// other without side information. The bit stream travels 14 bits to a halfword
+// in the same halfword stream as the records:
+//   0000 kkkk kkkk kkkk - keyframe: a raw 12-bit sample, restarting k
+//   01bb bbbb bbbb bbbb - 14 bits of the Rice stream, first bit in bit 13
+// so a record may fall between any two of them. The encoder is drained before
+// a stamp record and at the end of a session, padding the last halfword with
+// ones; those never make a whole code, so a decoder drops what is left of the
+// stream when the next keyframe comes (one starts every stamp block)
+//
+//*****************************************************************************
+
+#define RICE_TAG        0x4000     // Halfword of RICE_BITS bits of the Rice stream
+#define RICE_BITS       14         // Stream bits per halfword
+#define RICE_BLOCK      16         // Deltas per block of one k
+#define RICE_K_START    2          // k of the first block after a keyframe
+#define RICE_K_MAX      11         // Largest k
+#define RICE_ESC        8          // Quotient from which a delta is stored raw
+#define RICE_RAW_BITS   13         // Bits of a raw zigzag delta (12-bit samples)
+#define RICE_MAX_OUT    2          // Most halfwords one Rice_Encode call emits
+
+#if defined(__TI_ARM__)
+#define RICE_CLZ(X)     _norm(X)   // Leading zeros (CLZ), 32 for 0
+#else
+#define RICE_CLZ(X)     ((X) ? __builtin_clz(X) : 32)
+#endif
+
+typedef struct {
+    uint32_t Acc;                  // Stream bits not yet emitted (encoder) or decoded, newest in the low bits
+    uint32_t Sum;                  // Sum of the block's deltas so far
+    sample_t Prev;                 // Previous sample, the base of the next delta
+    uint8_t Bits;                  // Bits held in Acc
+    uint8_t K;                     // k of the block
+    uint8_t Count;                 // Deltas of the block so far
+    bool Escaped;                  // Decoder: the escape ones are taken, the raw delta is next
+    bool Keyed;                    // Encoder: a keyframe has been emitted since the last reset
+} rice_t;
+
+void Rice_Reset(rice_t *Rice);
+int Rice_Drain(rice_t *Rice, sample_t *Out);
+int Rice_Encode(rice_t *Rice, sample_t Sample, sample_t *Out);
+void Rice_Key(rice_t *Rice, sample_t Sample);
+void Rice_Put(rice_t *Rice, sample_t Half);
+bool Rice_Get(rice_t *Rice, sample_t *Sample);
+
+//*****************************************************************************
+//
+// Biquad Kernel: One direct form I section, y = b0 x0 + b1 x1 + b2 x2 - a1 y1
+// - a2 y2, coefficients in Q14, samples in Q15; each section is three dual
+// 16-bit multiply-accumulates (SMLAD on the target) rounded and saturated back
+// to 16 bits (SSAT); the packed operands are kept next to the coefficients
+//
+//*****************************************************************************
+
+#define FILTER_COEF_SHIFT  14      // Coefficients are Q14
+#define FILTER_ONE         (1 << FILTER_COEF_SHIFT)  // Coefficient 1.0
+
+#if defined(__TI_ARM__)
+#define DSP_SMLAD(X, Y, Acc) _smlad((X), (Y), (Acc))   // Acc + X.lo * Y.lo + X.hi * Y.hi
+#define DSP_SSAT16(X)      _ssata((X), 0, 16)          // Saturate to a signed 16-bit value
+#else
+#define DSP_SMLAD(X, Y, Acc) ((Acc) + (int16_t)(X) * (int16_t)(Y) + ((int32_t)(X) >> 16) * ((int32_t)(Y) >> 16))
+#define DSP_SSAT16(X)      (((X) > 32767) ? 32767 : ((X) < -32768) ? -32768 : (X))
+#endif
+#define DSP_PACK(Lo, Hi)   ((uint32_t)(uint16_t)(Lo) | ((uint32_t)(uint16_t)(Hi) << 16))  // Two halfwords
+
+typedef struct {
+    int16_t Coef[5];               // b0, b1, b2, a1, a2 in Q14
+    uint32_t B01;                  // Packed operands: b0 | b1
+    uint32_t B2A1;                 // b2 | -a1
+    uint32_t A2;                   // -a2 | 0
+} biquad_t;
+
+typedef struct {
+    int16_t X1, X2;                // Previous two inputs, Q15
+    int16_t Y1, Y2;                // Previous two outputs, Q15
+} biquad_state_t;
+
+void Biquad_Pack(biquad_t *Bq);
+int32_t Biquad_Cascade(const biquad_t *Bq, biquad_state_t *St, uint32_t Sections, int32_t X, bool Prime);
+
+//*****************************************************************************
+//
+// Median Kernel: A running median of the last 3, 5 or 7 samples, the window
+// kept in arrival order and sorted (see Median Filter Settings in main.c)
+//
+//*****************************************************************************
+
+#define MEDIAN_MAX         7       // Widest window
+
+typedef struct {
+    uint16_t Hist[MEDIAN_MAX];     // Window in arrival order (Hist[Pos] is the oldest)
+    uint16_t Sorted[MEDIAN_MAX];   // The same samples in ascending order
+    uint8_t Width;                 // Window (0 = off, 3, 5 or 7)
+    uint8_t Pos;                   // Oldest sample of Hist
+    bool Primed;                   // The window has been filled from a first sample
+} median_t;
+
+sample_t Median_Step(median_t *Med, sample_t Sample);
+
+//*****************************************************************************
+//
+// Byte Order: The replies, frames and records on the wire are most
+// significant byte first and the core is little-endian; the put helpers swap
+// a value in a register (REV, REV16 on the target) and store it with one
+// word or halfword store, which Cortex-M4 allows unaligned, rather than
+// shifting out each byte; Put_Le32 stores in the native order
+//
+//*****************************************************************************
+
+#if defined(__TI_ARM__)
+#define BSWAP32(X)      __rev(X)                   // Byte-reversed word (REV)
+#define BSWAP16(X)      ((uint16_t)__rev16(X))     // Byte-reversed halfword (REV16)
+#else
+#define BSWAP32(X)      __builtin_bswap32(X)
+#define BSWAP16(X)      __builtin_bswap16(X)
+#endif
+
+static inline void Put_Be32(uint8_t *Buf, uint32_t Value)
+{
+    Value = BSWAP32(Value);
+    memcpy(Buf, &Value, 4);
+}
+
+static inline void Put_Be16(uint8_t *Buf, uint16_t Value)
+{
+    Value = BSWAP16(Value);
+    memcpy(Buf, &Value, 2);
+}
+
+static inline void Put_Le32(uint8_t *Buf, uint32_t Value)
+{
+    memcpy(Buf, &Value, 4);
+}
+
+//*****************************************************************************
+//
+// Command Table: The command handlers in command byte order and the
+// transports each may run over (see Command Engine in main.c)
+//
+//*****************************************************************************
+
+#define CMD_SRC_CAN     0          // The request came over CAN
+#define CMD_SRC_I2C     1          // The request came over the I2C slave interface
+#define CMD_SRC_USB     2          // The request came over the USB bulk interface
+#define CMD_SRC_BATCH   3          // The command was staged in a batch and run from it
+
+#define CMD_F_CAN       0x01       // The command needs the CAN bus
+#define CMD_F_BULK      0x02       // The command streams its data (CAN or USB bulk only)
+
+typedef struct {
+    uint32_t Source;               // CMD_SRC_*
+    uint32_t Value;                // The 32-bit argument
+    uint32_t ReplyID;              // CAN ID the replies go to (CAN requests)
+    uint8_t *Resp;                 // CAN response frame with its header filled in (CAN requests)
+    uint32_t Replies;              // Reply words sent so far
+} cmd_ctx_t;
+
+typedef void (*cmd_handler_t)(cmd_ctx_t *Ctx);
+
+typedef struct {
+    uint8_t Command;               // Command byte (the entry's index + icmdReadVersion)
+    uint8_t Flags;                 // CMD_F_*
+    cmd_handler_t Handler;         // The handler, 0 = no such command
+} cmd_entry_t;
+
+const cmd_entry_t *Cmd_Find(const cmd_entry_t *Table, uint32_t Count, uint32_t Command);
+bool Cmd_Allowed(const cmd_entry_t *Entry, uint32_t Source);
+void Cmd_PutWord(uint8_t *Buf, uint32_t Value);
+
+//*****************************************************************************
+//
+// Front-End Driver Interface: An acquisition front end is a driver in the
+// manner of sensorlib's: a constant table of its operations, and an instance
+// that carries the callback, as a tBMP180 carries its I2CM callback. Init
+// sets the hardware up for a frame of Channels samples and Start starts or
+// stops the conversions; neither waits for the converter. When a frame is
+// in, the backend's interrupt reports it with FE_DataReady, which calls the
+// instance's callback, and the callback takes the frame with FE_DataGet
+// (only on FE_STATUS_OK). A new transducer type is a new table; the
+// acquisition pipeline behind the callback does not change
+//
+//*****************************************************************************
+
+#define FE_STATUS_OK    0          // A frame is in (the value of I2CM_STATUS_SUCCESS)
+#define FE_STATUS_ERROR 1          // A frame was missed or could not be read
+
+typedef void (*fe_callback_t)(void *pvData, uint_fast8_t ui8Status);  // As sensorlib's tSensorCallback
+
+typedef struct {
+    void (*Init)(uint32_t Channels);      // Set the hardware up for frames of Channels samples
+    void (*Start)(bool On);               // Start or stop the conversions
+    uint32_t (*Fetch)(uint32_t *Frame);   // Copy the frame out in channel order; returns its samples
+} fe_driver_t;
+
+typedef struct {
+    const fe_driver_t *Driver;     // The backend (0 until FE_Init)
+    fe_callback_t pfnCallback;     // Called for every frame reported (interrupt context)
+    void *pvCallbackData;          // Passed to the callback
+    uint32_t Frames;               // Frames reported in
+    uint32_t Errors;               // Frames reported missed or unreadable
+} fe_instance_t;
+
+void FE_Init(fe_instance_t *Inst, const fe_driver_t *Driver, uint32_t Channels,
+             fe_callback_t pfnCallback, void *pvCallbackData);
+void FE_Start(fe_instance_t *Inst, bool On);
+void FE_DataReady(fe_instance_t *Inst, uint_fast8_t ui8Status);
+uint32_t FE_DataGet(fe_instance_t *Inst, uint32_t *Frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IKCORE_H
@@ -28,18 +28,39 @@ MEMORY
 
 SECTIONS
 {
-    .intvecs:   > 0x00000000
-    .text   :   > FLASH
-    .const  :   > FLASH
-    .cinit  :   > FLASH
-    .pinit  :   > FLASH
-    .init_array : > FLASH
+    /* The program image is grouped from the vectors up so that its end can  */
+    /* be exported; the firmware logs to every flash page from               */
+    /* __flash_image_end to the end of the part's flash (see Log_InitRegion  */
+    /* in main.c)                                                            */
+    GROUP : > 0x00000000, END(__flash_image_end)
+    {
+        .intvecs
+        .text
+        .const
+        .cinit
+        .pinit
+        .init_array
+        .binit
+    }
+
+    /* Interrupt entry code that must run while the flash is busy; the boot  */
+    /* routine copies it to SRAM through the BINIT copy table (see the       */
+    /* SRAM-Resident Acquisition Settings in main.c)                         */
+    .TI.ramfunc : load > FLASH, run > SRAM, table(BINIT), LOAD_END(__ramfunc_load_end)
 
     .vtable :   > 0x20000000
-    .data   :   > SRAM
-    .bss    :   > SRAM
-    .sysmem :   > SRAM
-    .stack  :   > SRAM
+
+    /* The globals, the heap and the stack in one block: the link fails if   */
+    /* they do not fit the SRAM left after the vector table and the SRAM     */
+    /* code, and its end is exported for the SRAM report (see the SRAM       */
+    /* budget check in main.c)                                               */
+    GROUP : > SRAM, END(__sram_rw_end)
+    {
+        .data
+        .bss
+        .sysmem
+        .stack
+    }
 }
 
-__STACK_TOP = __stack + 512;
+__STACK_TOP = __stack + __STACK_SIZE;
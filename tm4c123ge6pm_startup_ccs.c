@@ -37,6 +37,22 @@ static void IntDefaultHandler(void);
 extern void IntCAN0Handler(void);
 extern void SysTickIntHandler(void);
 extern void I2C0SlaveIntHandler();
+extern void I2C1IntHandler(void);
+extern void UARTStdioIntHandler(void);
+extern void Usb_IntHandler(void);
+extern void ADC0SS0IntHandler(void);
+extern void ADC0SS3IntHandler(void);
+extern void ADC1SS3IntHandler(void);
+extern void FlashIntHandler(void);
+extern void CompWake_IntHandler(void);
+extern void Angle_IntHandler(void);
+extern void ExtTrig_IntHandler(void);
+extern void SpiAdc_DrdyIntHandler(void);
+extern void SpiAdc_IntHandler(void);
+extern void Xdcr_TimerIntHandler(void);
+extern void Defer_IntHandler(void);
+extern void Wdt_IntHandler(void);
+extern void Fault_Record(uint32_t *Frame);
 
 //*****************************************************************************
 //
@@ -75,9 +91,9 @@ void (* const g_pfnVectors[])(void) =
     ResetISR,                               // The reset handler
     NmiSR,                                  // The NMI handler
     FaultISR,                               // The hard fault handler
-    IntDefaultHandler,                      // The MPU fault handler
-    IntDefaultHandler,                      // The bus fault handler
-    IntDefaultHandler,                      // The usage fault handler
+    FaultISR,                               // The MPU fault handler
+    FaultISR,                               // The bus fault handler
+    FaultISR,                               // The usage fault handler
     0,                                      // Reserved
     0,                                      // Reserved
     0,                                      // Reserved
@@ -85,14 +101,14 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // SVCall handler
     IntDefaultHandler,                      // Debug monitor handler
     0,                                      // Reserved
-    IntDefaultHandler,                      // The PendSV handler
+    Defer_IntHandler,                       // The PendSV handler
     SysTickIntHandler,                      // The SysTick handler
     IntDefaultHandler,                      // GPIO Port A
     IntDefaultHandler,                      // GPIO Port B
     IntDefaultHandler,                      // GPIO Port C
-    IntDefaultHandler,                      // GPIO Port D
+    SpiAdc_DrdyIntHandler,                  // GPIO Port D
     IntDefaultHandler,                      // GPIO Port E
-    IntDefaultHandler,                      // UART0 Rx and Tx
+    UARTStdioIntHandler,                    // UART0 Rx and Tx
     IntDefaultHandler,                      // UART1 Rx and Tx
     IntDefaultHandler,                      // SSI0 Rx and Tx
     I2C0SlaveIntHandler,                      // I2C0 Master and Slave
@@ -101,51 +117,51 @@ void (* const g_pfnVectors[])(void) =
     IntDefaultHandler,                      // PWM Generator 1
     IntDefaultHandler,                      // PWM Generator 2
     IntDefaultHandler,                      // Quadrature Encoder 0
-    IntDefaultHandler,                      // ADC Sequence 0
+    ADC0SS0IntHandler,                      // ADC Sequence 0
     IntDefaultHandler,                      // ADC Sequence 1
     IntDefaultHandler,                      // ADC Sequence 2
-    IntDefaultHandler,                      // ADC Sequence 3
-    IntDefaultHandler,                      // Watchdog timer
-    IntDefaultHandler,                      // Timer 0 subtimer A
+    ADC0SS3IntHandler,                      // ADC Sequence 3
+    Wdt_IntHandler,                         // Watchdog timer
+    Xdcr_TimerIntHandler,                   // Timer 0 subtimer A
     IntDefaultHandler,                      // Timer 0 subtimer B
     IntDefaultHandler,                      // Timer 1 subtimer A
     IntDefaultHandler,                      // Timer 1 subtimer B
-    IntDefaultHandler,                      // Timer 2 subtimer A
+    Angle_IntHandler,                       // Timer 2 subtimer A
     IntDefaultHandler,                      // Timer 2 subtimer B
-    IntDefaultHandler,                      // Analog Comparator 0
+    CompWake_IntHandler,                    // Analog Comparator 0
     IntDefaultHandler,                      // Analog Comparator 1
     IntDefaultHandler,                      // Analog Comparator 2
     IntDefaultHandler,                      // System Control (PLL, OSC, BO)
-    IntDefaultHandler,                      // FLASH Control
-    IntDefaultHandler,                      // GPIO Port F
+    FlashIntHandler,                        // FLASH Control
+    ExtTrig_IntHandler,                     // GPIO Port F
     IntDefaultHandler,                      // GPIO Port G
     IntDefaultHandler,                      // GPIO Port H
     IntDefaultHandler,                      // UART2 Rx and Tx
     IntDefaultHandler,                      // SSI1 Rx and Tx
     IntDefaultHandler,                      // Timer 3 subtimer A
     IntDefaultHandler,                      // Timer 3 subtimer B
-    IntDefaultHandler,                      // I2C1 Master and Slave
+    I2C1IntHandler,                         // I2C1 Master and Slave
     IntDefaultHandler,                      // Quadrature Encoder 1
     IntCAN0Handler,                      // CAN0
     IntDefaultHandler,                      // CAN1
     0,                                      // Reserved
     0,                                      // Reserved
     IntDefaultHandler,                      // Hibernate
-    IntDefaultHandler,                      // USB0
+    Usb_IntHandler,                   // USB0
     IntDefaultHandler,                      // PWM Generator 3
     IntDefaultHandler,                      // uDMA Software Transfer
     IntDefaultHandler,                      // uDMA Error
     IntDefaultHandler,                      // ADC1 Sequence 0
     IntDefaultHandler,                      // ADC1 Sequence 1
     IntDefaultHandler,                      // ADC1 Sequence 2
-    IntDefaultHandler,                      // ADC1 Sequence 3
+    ADC1SS3IntHandler,                      // ADC1 Sequence 3
     0,                                      // Reserved
     0,                                      // Reserved
     IntDefaultHandler,                      // GPIO Port J
     IntDefaultHandler,                      // GPIO Port K
     IntDefaultHandler,                      // GPIO Port L
     IntDefaultHandler,                      // SSI2 Rx and Tx
-    IntDefaultHandler,                      // SSI3 Rx and Tx
+    SpiAdc_IntHandler,                      // SSI3 Rx and Tx
     IntDefaultHandler,                      // UART3 Rx and Tx
     IntDefaultHandler,                      // UART4 Rx and Tx
     IntDefaultHandler,                      // UART5 Rx and Tx
@@ -269,20 +285,24 @@ NmiSR(void)
 
 //*****************************************************************************
 //
-// This is the code that gets called when the processor receives a fault
-// interrupt.  This simply enters an infinite loop, preserving the system state
-// for examination by a debugger.
+// This is the code that gets called when the processor receives a hard,
+// memory management, bus or usage fault.  It hands the exception frame the
+// fault stacked (on the main or the process stack, as EXC_RETURN in LR tells)
+// to Fault_Record, which saves a crash record and resets.
 //
 //*****************************************************************************
 static void
 FaultISR(void)
 {
     //
-    // Enter an infinite loop.
+    // Find the stacked frame and jump to the recorder with it in R0.
     //
-    while(1)
-    {
-    }
+    __asm("    .global Fault_Record\n"
+          "    tst     lr, #4\n"
+          "    ite     eq\n"
+          "    mrseq   r0, msp\n"
+          "    mrsne   r0, psp\n"
+          "    b.w     Fault_Record");
 }
 
 //*****************************************************************************